@@ -0,0 +1,106 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "EnemyStateMachine.h"
+#include "OvermindBase.h"
+
+bool FEnemyStateTable::Compile(const UEnemyStateMachineAsset& Asset)
+{
+	StateActions.Reset();
+	StateAbilities.Reset();
+	FirstTransition.Reset();
+	Conditions.Reset();
+	Values.Reset();
+	Abilities.Reset();
+	Targets.Reset();
+
+	const int32 NumStates = FMath::Min(Asset.States.Num(), (int32)MaxStates);
+	if (NumStates < Asset.States.Num())
+	{
+		UE_LOG(LogOvermind, Warning, TEXT("Overmind: %s has more than %d states, the rest are ignored"), *Asset.GetName(), (int32)MaxStates);
+	}
+
+	TMap<FName, uint8> StateIndices;
+	for (int32 i = 0; i < NumStates; ++i)
+	{
+		StateIndices.Add(Asset.States[i].Name, (uint8)i);
+	}
+
+	for (int32 i = 0; i < NumStates; ++i)
+	{
+		const FEnemyStateDefinition& State = Asset.States[i];
+		StateActions.Add(State.Action);
+		StateAbilities.Add(State.Ability);
+		FirstTransition.Add(Conditions.Num());
+		for (const FEnemyStateTransition& Transition : State.Transitions)
+		{
+			const uint8* Target = StateIndices.Find(Transition.To);
+			if (!Target)
+			{
+				UE_LOG(LogOvermind, Warning, TEXT("Overmind: %s, state %s goes to %s which does not exist"), *Asset.GetName(), *State.Name.ToString(), *Transition.To.ToString());
+				continue;
+			}
+			Conditions.Add(Transition.Condition);
+			Values.Add(Transition.Value);
+			Abilities.Add((uint8)Transition.Ability);
+			Targets.Add(*Target);
+		}
+	}
+	FirstTransition.Add(Conditions.Num());
+
+	CloseGapMinRange = Asset.CloseGapMinRange;
+	CloseGapMaxRange = Asset.CloseGapMaxRange;
+	ChaseAcceptanceRadius = Asset.ChaseAcceptanceRadius;
+	return IsValid();
+}
+
+uint8 FEnemyStateTable::Step(uint8 State, const FEnemyStateInput& Input) const
+{
+	for (int32 t = FirstTransition[State]; t < FirstTransition[State + 1]; ++t)
+	{
+		bool bHolds = false;
+		switch (Conditions[t])
+		{
+		case EEnemyStateCondition::Always:
+			bHolds = true;
+			break;
+		case EEnemyStateCondition::HasTarget:
+			bHolds = Input.bHasTarget;
+			break;
+		case EEnemyStateCondition::NoTarget:
+			bHolds = !Input.bHasTarget;
+			break;
+		case EEnemyStateCondition::InCombat:
+			bHolds = Input.bInCombat;
+			break;
+		case EEnemyStateCondition::OutOfCombat:
+			bHolds = !Input.bInCombat;
+			break;
+		case EEnemyStateCondition::TargetCloserThan:
+			bHolds = Input.bHasTarget && Input.DistanceToTarget < Values[t];
+			break;
+		case EEnemyStateCondition::TargetFartherThan:
+			bHolds = Input.bHasTarget && Input.DistanceToTarget > Values[t];
+			break;
+		case EEnemyStateCondition::InCloseGapRange:
+			// If distance is 0 we have a problem...
+			bHolds = Input.bHasTarget && Input.DistanceToTarget > 0.1f && CloseGapMinRange < Input.DistanceToTarget && Input.DistanceToTarget < CloseGapMaxRange;
+			break;
+		case EEnemyStateCondition::AbilityReady:
+			bHolds = (Input.ReadyEffects & (1u << Abilities[t])) != 0;
+			break;
+		case EEnemyStateCondition::ActionFinished:
+			bHolds = !Input.bActionInProgress;
+			break;
+		case EEnemyStateCondition::TimeInStateAbove:
+			bHolds = Input.TimeInState > Values[t];
+			break;
+		}
+
+		if (bHolds)
+		{
+			return Targets[t];
+		}
+	}
+	return State;
+}
@@ -0,0 +1,139 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EnemyBase.h"
+#include "EnemyStateMachine.generated.h"
+
+// What has to be true for a transition to be taken.
+UENUM(BlueprintType)
+enum class EEnemyStateCondition : uint8
+{
+	Always				UMETA(DisplayName = "Always"),
+	HasTarget			UMETA(DisplayName = "Has Target"),
+	NoTarget			UMETA(DisplayName = "No Target"),
+	InCombat			UMETA(DisplayName = "In Combat"),
+	OutOfCombat			UMETA(DisplayName = "Out Of Combat"),
+	TargetCloserThan	UMETA(DisplayName = "Target Closer Than (Value)"),
+	TargetFartherThan	UMETA(DisplayName = "Target Farther Than (Value)"),
+	InCloseGapRange		UMETA(DisplayName = "In Close Gap Range"),
+	AbilityReady		UMETA(DisplayName = "Ability Ready (Ability)"),
+	ActionFinished		UMETA(DisplayName = "Action Finished"),
+	TimeInStateAbove	UMETA(DisplayName = "Time In State Above (Value)"),
+};
+
+// What an enemy does while in a state.
+UENUM(BlueprintType)
+enum class EEnemyStateAction : uint8
+{
+	Idle		UMETA(DisplayName = "Idle"),
+	Chase		UMETA(DisplayName = "Chase Target"),
+	Hold		UMETA(DisplayName = "Hold Position"),
+	UseAbility	UMETA(DisplayName = "Use Ability"),
+};
+
+USTRUCT(BlueprintType)
+struct FEnemyStateTransition
+{
+	GENERATED_BODY()
+
+	// State to go to, by name.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		FName To;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		EEnemyStateCondition Condition = EEnemyStateCondition::Always;
+	// Distance or seconds, for the conditions that need one.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		float Value = 0.0f;
+	// For AbilityReady.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		EEnemyAbilities Ability = EEnemyAbilities::Attack;
+};
+
+USTRUCT(BlueprintType)
+struct FEnemyStateDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		FName Name;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		EEnemyStateAction Action = EEnemyStateAction::Idle;
+	// For UseAbility, the first ready ability with this effect is started when the state is entered.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		EEnemyAbilities Ability = EEnemyAbilities::Attack;
+	// Checked in order every tick, the first one that holds is taken.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		TArray<FEnemyStateTransition> Transitions;
+};
+
+/**
+ * States and transitions of the native Mob AI, edited as data and compiled into an FEnemyStateTable by the Overmind.
+ * The first state is where enemies start when they are placed.
+ */
+UCLASS(BlueprintType)
+class NIGHTFALL_API UEnemyStateMachineAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "States")
+		TArray<FEnemyStateDefinition> States;
+
+	// Range used by InCloseGapRange, same test as AEnemyBase::CloseGap.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ranges")
+		float CloseGapMinRange = 250.0f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ranges")
+		float CloseGapMaxRange = 1500.0f;
+
+	// Distance at which chasing enemies stop moving.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ranges")
+		float ChaseAcceptanceRadius = 150.0f;
+};
+
+// What a transition can look at, gathered by the Overmind for each enemy.
+struct FEnemyStateInput
+{
+	float DistanceToTarget;
+	float TimeInState;
+	// Bit N set when an ability with effect N is off cooldown.
+	uint32 ReadyEffects;
+	bool bHasTarget;
+	bool bInCombat;
+	bool bActionInProgress;
+};
+
+/**
+ * Flat version of a UEnemyStateMachineAsset. Transitions of state S are Transitions[FirstTransition[S], FirstTransition[S + 1]),
+ * so stepping an enemy is a short loop over plain arrays with no names, no UObjects and no Blueprint.
+ */
+struct NIGHTFALL_API FEnemyStateTable
+{
+	static constexpr uint8 MaxStates = MAX_uint8;
+
+	TArray<EEnemyStateAction> StateActions;
+	TArray<EEnemyAbilities> StateAbilities;
+	TArray<int32> FirstTransition;
+
+	TArray<EEnemyStateCondition> Conditions;
+	TArray<float> Values;
+	TArray<uint8> Abilities;
+	TArray<uint8> Targets;
+
+	float CloseGapMinRange = 0.0f;
+	float CloseGapMaxRange = 0.0f;
+	float ChaseAcceptanceRadius = 0.0f;
+
+	// Resolve the names of the asset, transitions to states that do not exist are dropped with a warning.
+	bool Compile(const UEnemyStateMachineAsset& Asset);
+
+	bool IsValid() const
+	{
+		return StateActions.Num() > 0;
+	}
+
+	// State the enemy should be in after this tick, State itself if no transition holds.
+	uint8 Step(uint8 State, const FEnemyStateInput& Input) const;
+};
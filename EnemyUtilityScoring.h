@@ -0,0 +1,171 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnemyBase.h"
+
+// Everything the scorers need to know about one enemy, gathered by the Overmind before scoring.
+struct FEnemyDecisionInput
+{
+	int32 PoolIndex;
+	float DistanceToTarget;
+	float Threat;
+	// Abilities off cooldown, bit N being Abilities[N].
+	uint32 ReadyMask;
+	const FEnemyAbility* Abilities;
+	int32 NumAbilities;
+};
+
+// Ability picked for an enemy, AbilityIndex is -1 when nothing is worth doing.
+struct FEnemyDecision
+{
+	int32 PoolIndex;
+	int32 AbilityIndex;
+	float Score;
+};
+
+/**
+ * Tuning of each tier, read at compile time by the scorers so every tier gets its own loop.
+ * Ranges are in unreal units, weights are how much the tier likes each kind of ability.
+ * Threat goes from [1-0], 0 being the angriest, and makes special attacks more attractive.
+ */
+template<EEnemyTiers Tier>
+struct TEnemyTierTraits;
+
+template<>
+struct TEnemyTierTraits<EEnemyTiers::Mob>
+{
+	static constexpr float AttackRange = 200.0f;
+	static constexpr float SpecialRange = 400.0f;
+	static constexpr float CloseGapMinRange = 250.0f;
+	static constexpr float CloseGapMaxRange = 1500.0f;
+	static constexpr float AttackWeight = 1.0f;
+	static constexpr float SpecialWeight = 0.4f;
+	static constexpr float CloseGapWeight = 0.8f;
+	static constexpr float ThreatInfluence = 0.25f;
+};
+
+template<>
+struct TEnemyTierTraits<EEnemyTiers::Elite>
+{
+	static constexpr float AttackRange = 250.0f;
+	static constexpr float SpecialRange = 800.0f;
+	static constexpr float CloseGapMinRange = 300.0f;
+	static constexpr float CloseGapMaxRange = 2000.0f;
+	static constexpr float AttackWeight = 0.9f;
+	static constexpr float SpecialWeight = 0.7f;
+	static constexpr float CloseGapWeight = 0.7f;
+	static constexpr float ThreatInfluence = 0.5f;
+};
+
+template<>
+struct TEnemyTierTraits<EEnemyTiers::Boss>
+{
+	static constexpr float AttackRange = 350.0f;
+	static constexpr float SpecialRange = 1500.0f;
+	static constexpr float CloseGapMinRange = 400.0f;
+	static constexpr float CloseGapMaxRange = 3000.0f;
+	static constexpr float AttackWeight = 0.8f;
+	static constexpr float SpecialWeight = 1.0f;
+	static constexpr float CloseGapWeight = 0.6f;
+	static constexpr float ThreatInfluence = 1.0f;
+};
+
+/**
+ * Utility scorer specialized for one tier. Everything is resolved at compile time from the traits,
+ * so scoring a batch of enemies of the same tier is a tight loop with no virtual calls or Blueprint.
+ */
+template<typename TTraits>
+struct TEnemyUtilityScorer
+{
+	// How much an ability is worth given the distance to the target and how mad the enemy is.
+	static FORCEINLINE float ScoreAbility(EEnemyAbilities Effect, float Distance, float Threat)
+	{
+		// If distance is 0 we have a problem...
+		if (Distance <= 0.1f)
+		{
+			return 0.0f;
+		}
+
+		switch (Effect)
+		{
+		case EEnemyAbilities::Attack:
+			if (Distance > TTraits::AttackRange)
+			{
+				return 0.0f;
+			}
+			return TTraits::AttackWeight * (1.0f - 0.5f * (Distance / TTraits::AttackRange));
+
+		case EEnemyAbilities::Special:
+			if (Distance > TTraits::SpecialRange)
+			{
+				return 0.0f;
+			}
+			return TTraits::SpecialWeight * (1.0f + TTraits::ThreatInfluence * (1.0f - Threat));
+
+		case EEnemyAbilities::CloseGap:
+			if (Distance <= TTraits::CloseGapMinRange || Distance >= TTraits::CloseGapMaxRange)
+			{
+				return 0.0f;
+			}
+			// The farther the target, the more the gap needs closing.
+			return TTraits::CloseGapWeight * ((Distance - TTraits::CloseGapMinRange) / (TTraits::CloseGapMaxRange - TTraits::CloseGapMinRange));
+		}
+		return 0.0f;
+	}
+
+	// Best ready ability of one enemy.
+	static FORCEINLINE FEnemyDecision Pick(const FEnemyDecisionInput& Input)
+	{
+		FEnemyDecision Decision;
+		Decision.PoolIndex = Input.PoolIndex;
+		Decision.AbilityIndex = -1;
+		Decision.Score = 0.0f;
+
+		// Only walk the abilities that are off cooldown.
+		uint32 Ready = Input.ReadyMask;
+		while (Ready != 0)
+		{
+			const int32 AbilityIndex = FMath::CountTrailingZeros(Ready);
+			Ready &= Ready - 1;
+			if (AbilityIndex >= Input.NumAbilities)
+			{
+				break;
+			}
+
+			const float Score = ScoreAbility(Input.Abilities[AbilityIndex].AbilityEffect, Input.DistanceToTarget, Input.Threat);
+			if (Score > Decision.Score)
+			{
+				Decision.AbilityIndex = AbilityIndex;
+				Decision.Score = Score;
+			}
+		}
+		return Decision;
+	}
+
+	// Score every enemy of this tier in one pass, appending one decision per input.
+	static void PickBatch(const TArray<FEnemyDecisionInput>& Inputs, TArray<FEnemyDecision>& OutDecisions)
+	{
+		const int32 Start = OutDecisions.Num();
+		OutDecisions.AddUninitialized(Inputs.Num());
+		for (int32 i = 0; i < Inputs.Num(); ++i)
+		{
+			OutDecisions[Start + i] = Pick(Inputs[i]);
+		}
+	}
+};
+
+// Pick an ability for a single enemy, used when an enemy asks for a decision outside of the Overmind's batch.
+inline FEnemyDecision PickEnemyAbility(EEnemyTiers Tier, const FEnemyDecisionInput& Input)
+{
+	switch (Tier)
+	{
+	case EEnemyTiers::Boss:
+		return TEnemyUtilityScorer<TEnemyTierTraits<EEnemyTiers::Boss>>::Pick(Input);
+	case EEnemyTiers::Elite:
+		return TEnemyUtilityScorer<TEnemyTierTraits<EEnemyTiers::Elite>>::Pick(Input);
+	default:
+		return TEnemyUtilityScorer<TEnemyTierTraits<EEnemyTiers::Mob>>::Pick(Input);
+	}
+}
@@ -0,0 +1,94 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindCrowd.h"
+
+void FOvermindCrowd::Reset(int32 NumTypes)
+{
+	Locations.Reset();
+	Locations.SetNum(NumTypes);
+	Ids.Reset();
+	Ids.SetNum(NumTypes);
+	IdToProxy.Reset();
+	NumProxies = 0;
+}
+
+int32 FOvermindCrowd::Add(int32 TypeIndex, const FVector& Location, int32 Id)
+{
+	++NumProxies;
+	Ids[TypeIndex].Add(Id);
+	const int32 Index = Locations[TypeIndex].Add(Location);
+	IdToProxy.Add(Id, { TypeIndex, Index });
+	return Index;
+}
+
+int32 FOvermindCrowd::RemoveAtSwap(int32 TypeIndex, int32 Index)
+{
+	TArray<FVector>& TypeLocations = Locations[TypeIndex];
+	TArray<int32>& TypeIds = Ids[TypeIndex];
+	const int32 Last = TypeLocations.Num() - 1;
+	IdToProxy.Remove(TypeIds[Index]);
+	TypeLocations.RemoveAtSwap(Index, 1, false);
+	TypeIds.RemoveAtSwap(Index, 1, false);
+	--NumProxies;
+	if (Index == Last)
+	{
+		return INDEX_NONE;
+	}
+	IdToProxy[TypeIds[Index]].Index = Index;
+	return Last;
+}
+
+bool FOvermindCrowd::Find(int32 Id, FOvermindProxyRef& OutProxy) const
+{
+	const FOvermindProxyRef* Proxy = IdToProxy.Find(Id);
+	if (!Proxy)
+	{
+		return false;
+	}
+	OutProxy = *Proxy;
+	return true;
+}
+
+void FOvermindCrowd::Update(float DeltaTime, float Speed, const TArray<FVector>& PlayerLocations, float PromoteRange, TArray<FOvermindProxyRef>& OutPromotions)
+{
+	if (PlayerLocations.Num() == 0)
+	{
+		return;
+	}
+
+	const float PromoteRangeSquared = PromoteRange * PromoteRange;
+	const float Step = Speed * DeltaTime;
+	for (int32 TypeIndex = 0; TypeIndex < Locations.Num(); ++TypeIndex)
+	{
+		TArray<FVector>& TypeLocations = Locations[TypeIndex];
+		for (int32 i = 0; i < TypeLocations.Num(); ++i)
+		{
+			FVector& Location = TypeLocations[i];
+
+			// Closest player, on the ground plane, proxies do not fly.
+			FVector ToPlayer = FVector::ZeroVector;
+			float ClosestSquared = MAX_flt;
+			for (int32 p = 0; p < PlayerLocations.Num(); ++p)
+			{
+				const FVector Difference(PlayerLocations[p].X - Location.X, PlayerLocations[p].Y - Location.Y, 0.0f);
+				const float DistanceSquared = Difference.SizeSquared();
+				if (DistanceSquared < ClosestSquared)
+				{
+					ClosestSquared = DistanceSquared;
+					ToPlayer = Difference;
+				}
+			}
+
+			if (ClosestSquared <= PromoteRangeSquared)
+			{
+				OutPromotions.Add({ TypeIndex, i });
+				continue;
+			}
+
+			// Never step past the edge of the promote range.
+			const float Distance = FMath::Sqrt(ClosestSquared);
+			Location += ToPlayer * (FMath::Min(Step, Distance - PromoteRange) / Distance);
+		}
+	}
+}
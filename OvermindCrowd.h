@@ -0,0 +1,82 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// A proxy close enough to a player to become a real enemy.
+struct FOvermindProxyRef
+{
+	int32 TypeIndex;
+	int32 Index;
+};
+
+/**
+ * Enemies that are far from the players, or not fighting, kept as plain rows instead of characters.
+ * Proxies are grouped by enemy type (position on the Overmind's SpawnInfo) and stored densely, so index N of a type is
+ * instance N of that type's instanced mesh. Moving them is one loop over locations, no capsule, movement component or skeleton.
+ */
+class NIGHTFALL_API FOvermindCrowd
+{
+public:
+	// Forget every proxy and make room for this many types.
+	void Reset(int32 NumTypes);
+
+	// Add a proxy, returns its index inside the type. Id names the proxy on server and clients alike, indices move around.
+	int32 Add(int32 TypeIndex, const FVector& Location, int32 Id);
+
+	/**
+	* Remove a proxy, the last proxy of the type takes its index.
+	* @return	Index the last proxy was moved from, INDEX_NONE if nothing moved.
+	*/
+	int32 RemoveAtSwap(int32 TypeIndex, int32 Index);
+
+	/**
+	* Walk every proxy toward its closest player. Proxies already inside PromoteRange of a player stop and are appended
+	* to OutPromotions, the caller turns them into real enemies (or leaves them waiting if the pool is empty).
+	* @param	Speed: Unreal units per second.
+	*/
+	void Update(float DeltaTime, float Speed, const TArray<FVector>& PlayerLocations, float PromoteRange, TArray<FOvermindProxyRef>& OutPromotions);
+
+	FORCEINLINE int32 NumTypes() const
+	{
+		return Locations.Num();
+	}
+
+	FORCEINLINE int32 Num(int32 TypeIndex) const
+	{
+		return Locations[TypeIndex].Num();
+	}
+
+	// Every proxy of every type.
+	FORCEINLINE int32 Num() const
+	{
+		return NumProxies;
+	}
+
+	FORCEINLINE const TArray<FVector>& GetLocations(int32 TypeIndex) const
+	{
+		return Locations[TypeIndex];
+	}
+
+	FORCEINLINE const TArray<int32>& GetIds(int32 TypeIndex) const
+	{
+		return Ids[TypeIndex];
+	}
+
+	FORCEINLINE void SetLocation(int32 TypeIndex, int32 Index, const FVector& Location)
+	{
+		Locations[TypeIndex][Index] = Location;
+	}
+
+	// Where the proxy with this id is now, false if there is none.
+	bool Find(int32 Id, FOvermindProxyRef& OutProxy) const;
+
+private:
+
+	// One dense array per type, ids next to the locations.
+	TArray<TArray<FVector>> Locations;
+	TArray<TArray<int32>> Ids;
+	TMap<int32, FOvermindProxyRef> IdToProxy;
+	int32 NumProxies = 0;
+};
@@ -0,0 +1,104 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindFrameArena.h"
+#include "OvermindSpawnFunnel.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame arena bytes"), STAT_OvermindArenaBytes, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame arena heap allocations"), STAT_OvermindArenaHeapAllocations, STATGROUP_Overmind);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frame arena heap allocations (total)"), STAT_OvermindArenaHeapAllocationsTotal, STATGROUP_Overmind);
+DECLARE_MEMORY_STAT(TEXT("Frame arena capacity"), STAT_OvermindArenaCapacity, STATGROUP_Overmind);
+
+static thread_local FOvermindFrameArena* CurrentArena = nullptr;
+
+FOvermindFrameArena::FOvermindFrameArena(int32 InitialBytes) :
+	Block(nullptr), Capacity(FMath::Max(InitialBytes, 1024)), Used(0), Overflow(nullptr), OverflowBytes(0), PeakBytes(0), NumHeapAllocations(1), FrameHeapAllocations(0), ScopeDepth(0)
+{
+	Block = (uint8*)FMemory::Malloc(Capacity);
+	INC_MEMORY_STAT_BY(STAT_OvermindArenaCapacity, Capacity);
+}
+
+FOvermindFrameArena::~FOvermindFrameArena()
+{
+	FreeOverflow();
+	DEC_MEMORY_STAT_BY(STAT_OvermindArenaCapacity, Capacity);
+	FMemory::Free(Block);
+}
+
+void* FOvermindFrameArena::Alloc(SIZE_T Size, uint32 Alignment)
+{
+	uint8* Top = Align(Block + Used, Alignment);
+	if (Top + Size <= Block + Capacity)
+	{
+		Used = (Top + Size) - Block;
+		return Top;
+	}
+
+	// Does not fit, borrow from the heap until the next Reset grows the block.
+	const SIZE_T HeaderSize = Align(sizeof(void*), Alignment);
+	uint8* Chunk = (uint8*)FMemory::Malloc(HeaderSize + Size, FMath::Max(Alignment, (uint32)sizeof(void*)));
+	*(void**)Chunk = Overflow;
+	Overflow = Chunk;
+	OverflowBytes += Size + Alignment;
+	NumHeapAllocations++;
+	FrameHeapAllocations++;
+	return Chunk + HeaderSize;
+}
+
+void FOvermindFrameArena::Reset()
+{
+	const SIZE_T FrameBytes = Used + OverflowBytes;
+	PeakBytes = FMath::Max(PeakBytes, FrameBytes);
+
+	FreeOverflow();
+
+	// Make room for a frame like this one, so the next ones stay off the heap.
+	if (OverflowBytes > 0)
+	{
+		DEC_MEMORY_STAT_BY(STAT_OvermindArenaCapacity, Capacity);
+		FMemory::Free(Block);
+		Capacity = FMath::RoundUpToPowerOfTwo64(PeakBytes);
+		Block = (uint8*)FMemory::Malloc(Capacity);
+		INC_MEMORY_STAT_BY(STAT_OvermindArenaCapacity, Capacity);
+		NumHeapAllocations++;
+		FrameHeapAllocations++;
+	}
+
+	SET_DWORD_STAT(STAT_OvermindArenaBytes, FrameBytes);
+	INC_DWORD_STAT_BY(STAT_OvermindArenaHeapAllocations, FrameHeapAllocations);
+	INC_DWORD_STAT_BY(STAT_OvermindArenaHeapAllocationsTotal, FrameHeapAllocations);
+
+	Used = 0;
+	OverflowBytes = 0;
+	FrameHeapAllocations = 0;
+}
+
+void FOvermindFrameArena::FreeOverflow()
+{
+	while (Overflow)
+	{
+		void* Next = *(void**)Overflow;
+		FMemory::Free(Overflow);
+		Overflow = Next;
+	}
+}
+
+FOvermindFrameArena* FOvermindFrameArena::GetCurrent()
+{
+	return CurrentArena;
+}
+
+FOvermindFrameArena::FScope::FScope(FOvermindFrameArena& InArena) : Arena(InArena), Previous(CurrentArena)
+{
+	CurrentArena = &Arena;
+	Arena.ScopeDepth++;
+}
+
+FOvermindFrameArena::FScope::~FScope()
+{
+	CurrentArena = Previous;
+	if (--Arena.ScopeDepth == 0)
+	{
+		Arena.Reset();
+	}
+}
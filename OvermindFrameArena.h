@@ -0,0 +1,172 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Linear allocator for the temporaries of one Overmind tick (or timer, or Blueprint call).
+ * Allocating moves a pointer forward, nothing is freed until the outermost FScope of the arena closes and throws it all away.
+ * When a frame does not fit, the overflow goes to the heap and is counted, and the next Reset grows the block
+ * to the biggest frame seen so far. Once it has grown, the arena itself stops going to the heap. Only the arena's
+ * allocations are counted, whatever else the Overmind allocates (engine calls, containers outside the arena) is not.
+ */
+class NIGHTFALL_API FOvermindFrameArena
+{
+public:
+	explicit FOvermindFrameArena(int32 InitialBytes = 64 * 1024);
+	~FOvermindFrameArena();
+
+	void* Alloc(SIZE_T Size, uint32 Alignment);
+
+	// Forget everything allocated since the last Reset. Containers still holding arena memory must be gone by now.
+	// Done by the outermost FScope when it closes, no need to call it when going through scopes.
+	void Reset();
+
+	// Heap allocations made by the arena since it was created, including the ones to grow the block. Not the Overmind's other allocations.
+	uint32 GetNumHeapAllocations() const
+	{
+		return NumHeapAllocations;
+	}
+
+	// Most bytes a single frame used.
+	SIZE_T GetPeakBytes() const
+	{
+		return PeakBytes;
+	}
+
+	// Arena TOvermindFrameAllocator containers allocate from on this thread, null outside of an FScope.
+	static FOvermindFrameArena* GetCurrent();
+
+	// Make an arena the current one for as long as the scope lives. Closing the outermost scope of an arena resets it,
+	// so every entry point (Tick, timers, Blueprint calls) gives back what it used. Game thread only.
+	struct NIGHTFALL_API FScope
+	{
+		explicit FScope(FOvermindFrameArena& InArena);
+		~FScope();
+
+		FOvermindFrameArena& Arena;
+		FOvermindFrameArena* Previous;
+	};
+
+private:
+
+	FOvermindFrameArena(const FOvermindFrameArena&) = delete;
+	FOvermindFrameArena& operator=(const FOvermindFrameArena&) = delete;
+
+	void FreeOverflow();
+
+	uint8* Block;
+	SIZE_T Capacity;
+	SIZE_T Used;
+
+	// Heap chunks of this frame that did not fit in the block, each starts with a pointer to the next one.
+	void* Overflow;
+	SIZE_T OverflowBytes;
+
+	SIZE_T PeakBytes;
+	uint32 NumHeapAllocations;
+	// Heap allocations since the last Reset, reported to the stats.
+	uint32 FrameHeapAllocations;
+	// Scopes of this arena open right now.
+	int32 ScopeDepth;
+};
+
+/**
+ * Container allocator taking its memory from the current FOvermindFrameArena, TArray<int32, TOvermindFrameAllocator<>>.
+ * Growing leaves the old allocation behind in the arena, reserve when the size is known.
+ */
+template<uint32 Alignment = DEFAULT_ALIGNMENT>
+class TOvermindFrameAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = true };
+	enum { RequireRangeCheck = true };
+
+	template<typename ElementType>
+	class ForElementType
+	{
+	public:
+		ForElementType() : Data(nullptr)
+		{
+		}
+
+		FORCEINLINE void MoveToEmpty(ForElementType& Other)
+		{
+			checkSlow(this != &Other);
+			Data = Other.Data;
+			Other.Data = nullptr;
+		}
+
+		FORCEINLINE ElementType* GetAllocation() const
+		{
+			return Data;
+		}
+
+		void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement)
+		{
+			ElementType* OldData = Data;
+			if (NumElements > 0)
+			{
+				FOvermindFrameArena* Arena = FOvermindFrameArena::GetCurrent();
+				check(Arena);
+				Data = (ElementType*)Arena->Alloc(NumElements * NumBytesPerElement, FMath::Max(Alignment, (uint32)alignof(ElementType)));
+				if (OldData && PreviousNumElements > 0)
+				{
+					FMemory::Memcpy(Data, OldData, FMath::Min(NumElements, PreviousNumElements) * NumBytesPerElement);
+				}
+			}
+			else
+			{
+				Data = nullptr;
+			}
+		}
+
+		FORCEINLINE SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NumElements, NumBytesPerElement, false, Alignment);
+		}
+
+		FORCEINLINE SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			// Shrinking gives nothing back to the arena, keep the slack.
+			return NumAllocatedElements;
+		}
+
+		FORCEINLINE SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false, Alignment);
+		}
+
+		FORCEINLINE SIZE_T GetAllocatedSize(SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return NumAllocatedElements * NumBytesPerElement;
+		}
+
+		FORCEINLINE bool HasAllocation() const
+		{
+			return Data != nullptr;
+		}
+
+		FORCEINLINE SizeType GetInitialCapacity() const
+		{
+			return 0;
+		}
+
+	private:
+		ForElementType(const ForElementType&) = delete;
+		ForElementType& operator=(const ForElementType&) = delete;
+
+		ElementType* Data;
+	};
+
+	typedef void ForAnyElementType;
+};
+
+template<uint32 Alignment>
+struct TAllocatorTraits<TOvermindFrameAllocator<Alignment>> : TAllocatorTraitsBase<TOvermindFrameAllocator<Alignment>>
+{
+	enum { IsZeroConstruct = true };
+};
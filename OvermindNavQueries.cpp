@@ -0,0 +1,188 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindNavQueries.h"
+#include "NavigationData.h"
+
+FOvermindNavQueryService::FOvermindNavQueryService() : NextId(0)
+{
+}
+
+FOvermindNavQueryService::~FOvermindNavQueryService()
+{
+	Flush();
+}
+
+int32 FOvermindNavQueryService::RequestReachablePoint(const FVector& Origin, const FVector& Candidate, int32 UserData)
+{
+	FOvermindNavQuery Query;
+	Query.Id = NextId++;
+	Query.UserData = UserData;
+	Query.Type = EOvermindNavQueryType::ReachablePoint;
+	Query.Origin = Origin;
+	Query.Target = Candidate;
+	Query.Radius = 0.0f;
+	Queued.Add(Query);
+	return Query.Id;
+}
+
+int32 FOvermindNavQueryService::RequestPathLength(const FVector& From, const FVector& To, int32 UserData)
+{
+	FOvermindNavQuery Query;
+	Query.Id = NextId++;
+	Query.UserData = UserData;
+	Query.Type = EOvermindNavQueryType::PathLength;
+	Query.Origin = From;
+	Query.Target = To;
+	Query.Radius = 0.0f;
+	Queued.Add(Query);
+	return Query.Id;
+}
+
+int32 FOvermindNavQueryService::RequestReachablePointInRadius(const FVector& Origin, float Radius, int32 UserData)
+{
+	FOvermindNavQuery Query;
+	Query.Id = NextId++;
+	Query.UserData = UserData;
+	Query.Type = EOvermindNavQueryType::ReachableInRadius;
+	Query.Origin = Origin;
+	Query.Target = Origin;
+	Query.Radius = Radius;
+	Queued.Add(Query);
+	return Query.Id;
+}
+
+void FOvermindNavQueryService::SetRandom(const FOvermindRandom& InRandom)
+{
+	if (Task.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task);
+	}
+	Random = InRandom;
+}
+
+const FOvermindRandom& FOvermindNavQueryService::GetRandom()
+{
+	if (Task.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task);
+	}
+	return Random;
+}
+
+void FOvermindNavQueryService::Kick(const ANavigationData* NavData, bool bUseWorkerThread)
+{
+	if (Queued.Num() == 0 || Running.Num() > 0)
+	{
+		return;
+	}
+
+	Swap(Queued, Running);
+	Results.Reset();
+	if (!bUseWorkerThread || !NavData)
+	{
+		RunBatch(NavData, Running, Random, RandomNumbers, Results);
+		return;
+	}
+
+	Task = FFunctionGraphTask::CreateAndDispatchWhenReady([this, NavData]()
+	{
+		RunBatch(NavData, Running, Random, RandomNumbers, Results);
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void FOvermindNavQueryService::Complete(TArray<FOvermindNavResult>& OutResults)
+{
+	OutResults.Reset();
+	if (Running.Num() == 0 || (Task.IsValid() && !Task->IsComplete()))
+	{
+		return;
+	}
+
+	Task = nullptr;
+	Swap(OutResults, Results);
+	Running.Reset();
+}
+
+void FOvermindNavQueryService::WaitForBatch()
+{
+	if (Task.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task);
+	}
+}
+
+void FOvermindNavQueryService::Flush()
+{
+	if (Task.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task);
+		Task = nullptr;
+	}
+	Queued.Reset();
+	Running.Reset();
+	Results.Reset();
+}
+
+void FOvermindNavQueryService::RunBatch(const ANavigationData* NavData, const TArray<FOvermindNavQuery>& Queries, FOvermindRandom& Random, TArray<float>& RandomNumbers, TArray<FOvermindNavResult>& OutResults)
+{
+	// Same extent the Overmind uses to find the floor under a point.
+	const FVector Extent(200.0f, 200.0f, 1000.0f);
+	FSharedConstNavQueryFilter Filter = NavData ? NavData->GetDefaultQueryFilter() : nullptr;
+
+	// Two numbers per random point, taken in queue order so the same queries always land on the same points.
+	int32 NumRandomPoints = 0;
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		NumRandomPoints += Queries[i].Type == EOvermindNavQueryType::ReachableInRadius;
+	}
+	RandomNumbers.SetNumUninitialized(NumRandomPoints * 2);
+	Random.FillFloats(RandomNumbers.GetData(), RandomNumbers.Num());
+	int32 NextRandom = 0;
+
+	OutResults.SetNumUninitialized(Queries.Num());
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		const FOvermindNavQuery& Query = Queries[i];
+		FOvermindNavResult& Result = OutResults[i];
+		Result.Id = Query.Id;
+		Result.UserData = Query.UserData;
+		Result.bSuccess = false;
+		Result.Location = Query.Target;
+		Result.PathLength = 0.0f;
+
+		// No navmesh to ask, the query fails.
+		if (!NavData)
+		{
+			continue;
+		}
+
+		switch (Query.Type)
+		{
+		case EOvermindNavQueryType::ReachableInRadius:
+		{
+			// Uniform over the disc, not bunched up in the middle.
+			const float Distance = Query.Radius * FMath::Sqrt(RandomNumbers[NextRandom++]);
+			const float Angle = RandomNumbers[NextRandom++] * 2.0f * PI;
+			Result.Location = Query.Origin + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.0f);
+		}
+		// Fall through, the rest is a ReachablePoint query on the picked point.
+		case EOvermindNavQueryType::ReachablePoint:
+		{
+			FNavLocation Start;
+			FNavLocation Point;
+			if (NavData->ProjectPoint(Query.Origin, Start, Extent, Filter) && NavData->ProjectPoint(Result.Location, Point, Extent, Filter))
+			{
+				FPathFindingQuery PathQuery(nullptr, *NavData, Start.Location, Point.Location, Filter);
+				Result.bSuccess = NavData->TestHierarchicalPath(FNavAgentProperties::DefaultProperties, PathQuery, nullptr);
+				Result.Location = Point.Location;
+			}
+			break;
+		}
+
+		case EOvermindNavQueryType::PathLength:
+			Result.bSuccess = NavData->CalcPathLength(Query.Origin, Query.Target, Result.PathLength, Filter) == ENavigationQueryResult::Success;
+			break;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "OvermindRandom.h"
+
+class ANavigationData;
+
+enum class EOvermindNavQueryType : uint8
+{
+	ReachablePoint,		// Origin and Target are projected on the navmesh, succeeds if Target can be walked to from Origin.
+	ReachableInRadius,	// ReachablePoint with Target picked by the worker within Radius of Origin.
+	PathLength,			// Length of the path from Origin to Target.
+};
+
+struct FOvermindNavQuery
+{
+	int32 Id;
+	// Whatever the caller needs to find its way back to the request.
+	int32 UserData;
+	EOvermindNavQueryType Type;
+	FVector Origin;
+	FVector Target;
+	// ReachableInRadius only.
+	float Radius;
+};
+
+struct FOvermindNavResult
+{
+	int32 Id;
+	int32 UserData;
+	bool bSuccess;
+	// Target on the navmesh (ReachablePoint).
+	FVector Location;
+	// PathLength only.
+	float PathLength;
+};
+
+/**
+ * Batches navmesh queries of the Overmind and runs them off the game thread.
+ * Queries asked during a frame are started together by Kick and their results are picked up by Complete on a later
+ * frame, the game thread never waits on the navmesh. Workers only read the navmesh, so the owner only asks for a worker
+ * when nothing can change it meanwhile, otherwise the batch is run on the game thread at Kick time instead.
+ */
+class NIGHTFALL_API FOvermindNavQueryService
+{
+public:
+	FOvermindNavQueryService();
+	~FOvermindNavQueryService();
+
+	// Queue queries for the next Kick, returns the query id.
+	int32 RequestReachablePoint(const FVector& Origin, const FVector& Candidate, int32 UserData);
+	int32 RequestPathLength(const FVector& From, const FVector& To, int32 UserData);
+	// ReachablePoint on a random point within Radius of Origin, drawn from the service's stream in queue order.
+	int32 RequestReachablePointInRadius(const FVector& Origin, float Radius, int32 UserData);
+
+	// Stream the batches draw their random numbers from, owned by the worker while a batch runs.
+	void SetRandom(const FOvermindRandom& InRandom);
+	// Waits for the running batch so the stream is not read while it draws.
+	const FOvermindRandom& GetRandom();
+
+	/**
+	* Start on everything queued since the last Kick. Does nothing while the previous batch is still running,
+	* the queue just keeps growing until the next Kick.
+	* @param	NavData: Navmesh to ask, with none every query of the batch fails.
+	* @param	bUseWorkerThread: Run the batch on a worker, only if nothing can change the navmesh meanwhile.
+	*/
+	void Kick(const ANavigationData* NavData, bool bUseWorkerThread);
+
+	// Hand over the results of the last batch if it is done, never waits.
+	void Complete(TArray<FOvermindNavResult>& OutResults);
+
+	// Wait for the running batch, its results are still picked up by Complete. For when the navmesh is about to change.
+	void WaitForBatch();
+
+	// Wait for the running batch and drop everything, for shutting down.
+	void Flush();
+
+	// Queries asked for and not delivered yet.
+	int32 NumOutstanding() const
+	{
+		return Queued.Num() + Running.Num();
+	}
+
+private:
+
+	static void RunBatch(const ANavigationData* NavData, const TArray<FOvermindNavQuery>& Queries, FOvermindRandom& Random, TArray<float>& RandomNumbers, TArray<FOvermindNavResult>& OutResults);
+
+	TArray<FOvermindNavQuery> Queued;
+	// Owned by the worker while Task is running.
+	TArray<FOvermindNavQuery> Running;
+	TArray<FOvermindNavResult> Results;
+	FOvermindRandom Random;
+	// Numbers of the running batch, drawn all at once.
+	TArray<float> RandomNumbers;
+	FGraphEventRef Task;
+	int32 NextId;
+};
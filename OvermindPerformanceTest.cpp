@@ -0,0 +1,242 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindPerformanceTest.h"
+#include "OvermindBase.h"
+#include "ANephilimBase.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+AOvermindPerformanceTest::AOvermindPerformanceTest() :
+	Overmind(nullptr), NumBots(2), BotPathRadius(2000.0f), BotSpeed(400.0f), RampTime(20.0f), MeasureTime(10.0f),
+	StageIndex(0), Step(EStep::Done), StepTime(0.0f), BotAngle(0.0f), bAnyStageFailed(false)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	TimeLimit = 600.0f;
+
+	FOvermindPerformanceStage Stage;
+	Stage.EnemyCount = 50;
+	Stage.MaxOvermindMilliseconds = 0.5f;
+	Stages.Add(Stage);
+	Stage.EnemyCount = 200;
+	Stage.MaxOvermindMilliseconds = 1.5f;
+	Stages.Add(Stage);
+	Stage.EnemyCount = 1000;
+	Stage.MaxOvermindMilliseconds = 6.0f;
+	Stages.Add(Stage);
+}
+
+void AOvermindPerformanceTest::StartTest()
+{
+	Super::StartTest();
+
+	if (!Overmind || !BotClass || Stages.Num() == 0)
+	{
+		FinishTest(EFunctionalTestResult::Error, TEXT("Overmind, BotClass and at least one stage are needed"));
+		return;
+	}
+
+	// Scripted bots take the place of the players.
+	FActorSpawnParameters SpawnParameter;
+	SpawnParameter.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	for (int32 i = 0; i < NumBots; ++i)
+	{
+		const float Angle = (2.0f * PI * i) / NumBots;
+		FVector Location = GetActorLocation() + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * BotPathRadius;
+		AANephilimBase* Bot = GetWorld()->SpawnActor<AANephilimBase>(BotClass, Location, FRotator::ZeroRotator, SpawnParameter);
+		if (Bot)
+		{
+			Bot->Team = ETeams::Player;
+			Bots.Add(Bot);
+		}
+	}
+	if (Bots.Num() == 0)
+	{
+		FinishTest(EFunctionalTestResult::Error, TEXT("Could not spawn any bot"));
+		return;
+	}
+	Overmind->SetPlayers(Bots);
+
+	CsvFileName = FPaths::ProjectSavedDir() / TEXT("Automation") / FString::Printf(TEXT("OvermindPerformance_%s.csv"), *FDateTime::Now().ToString());
+	CsvLines.Reset();
+	CsvLines.Add(TEXT("Enemies,Loops,Pool,ActiveEnemies,Frames,CooldownsMs,GroupLocationMs,VisionMs,DistanceCheckMs,ActionPickingMs,SpawnMs,CrowdMs,SeparationMs,ActivationMs,WorstActivationMs,MobAIMs,PipelineMs,TotalMs,AverageSpawnLatency,WorstSpawnLatency,RangeDespawns,ChurnedSpawns,Recycles,ArenaHeapAllocations,GcMs,MemoryMB,Passed"));
+	bAnyStageFailed = false;
+
+	StageIndex = 0;
+	BeginStage();
+}
+
+void AOvermindPerformanceTest::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bIsRunning || Step == EStep::Done)
+	{
+		return;
+	}
+
+	MoveBots(DeltaSeconds);
+	StepTime += DeltaSeconds;
+
+	const FOvermindPerformanceStage& Stage = Stages[StageIndex];
+	if (Step == EStep::Ramp)
+	{
+		// Keep asking for enemies until the stage is full or the ramp time runs out, spawns already on their way count.
+		const int32 Missing = Stage.EnemyCount - Overmind->GetNumActiveEnemies() - Overmind->GetNumPendingSpawns();
+		if (Missing > 0 && StepTime < RampTime)
+		{
+			Overmind->SpawnWave(Missing);
+			return;
+		}
+
+		Step = EStep::Measure;
+		StepTime = 0.0f;
+		StartTimings = Overmind->GetPhaseTimings();
+		return;
+	}
+
+	if (StepTime < MeasureTime)
+	{
+		return;
+	}
+
+	if (!EndStage())
+	{
+		bAnyStageFailed = true;
+	}
+
+	StageIndex++;
+	if (StageIndex < Stages.Num())
+	{
+		BeginStage();
+		return;
+	}
+
+	Step = EStep::Done;
+	FFileHelper::SaveStringArrayToFile(CsvLines, *CsvFileName);
+	for (AANephilimBase* Bot : Bots)
+	{
+		if (Bot)
+		{
+			Bot->Destroy();
+		}
+	}
+	Bots.Reset();
+
+	if (bAnyStageFailed)
+	{
+		FinishTest(EFunctionalTestResult::Failed, FString::Printf(TEXT("Overmind went over its thresholds, see %s"), *CsvFileName));
+	}
+	else
+	{
+		FinishTest(EFunctionalTestResult::Succeeded, FString::Printf(TEXT("Results in %s"), *CsvFileName));
+	}
+}
+
+void AOvermindPerformanceTest::BeginStage()
+{
+	Overmind->GrowPool(Stages[StageIndex].EnemyCount);
+	Overmind->bSpecializedLoops = !Stages[StageIndex].bGenericLoops;
+	Overmind->bClusterEnemyPool = Stages[StageIndex].bClusterPool;
+	Step = EStep::Ramp;
+	StepTime = 0.0f;
+	Overmind->ResetWorstTimings();
+	StageStartTimings = Overmind->GetPhaseTimings();
+}
+
+bool AOvermindPerformanceTest::EndStage()
+{
+	const FOvermindPerformanceStage& Stage = Stages[StageIndex];
+	const FOvermindPhaseTimings& Timings = Overmind->GetPhaseTimings();
+
+	const uint64 Frames = FMath::Max<uint64>(Timings.NumFrames - StartTimings.NumFrames, 1);
+	double PhaseMilliseconds[(uint8)EOvermindPhase::Num];
+	double TotalMilliseconds = 0.0;
+	for (int32 Phase = 0; Phase < (int32)EOvermindPhase::Num; ++Phase)
+	{
+		PhaseMilliseconds[Phase] = (Timings.TotalMilliseconds[Phase] - StartTimings.TotalMilliseconds[Phase]) / Frames;
+		TotalMilliseconds += PhaseMilliseconds[Phase];
+	}
+
+	// Latency counts everything spawned in the stage, ramp included, that is when most spawns happen.
+	const uint64 Spawns = Timings.NumSpawns - StageStartTimings.NumSpawns;
+	const float AverageLatency = Spawns > 0 ? (float)((Timings.TotalSpawnLatency - StageStartTimings.TotalSpawnLatency) / Spawns) : 0.0f;
+	const float MemoryMegabytes = FPlatformMemory::GetStats().UsedPhysical / (1024.0f * 1024.0f);
+	// After the frame timings, collections are hitches of their own.
+	const float GarbageCollectionMilliseconds = MeasureGarbageCollection();
+	const uint64 ArenaHeapAllocations = Timings.NumArenaHeapAllocations - StartTimings.NumArenaHeapAllocations;
+
+	bool bPassed = true;
+	if (Stage.MaxOvermindMilliseconds > 0.0f && TotalMilliseconds > Stage.MaxOvermindMilliseconds)
+	{
+		AddError(FString::Printf(TEXT("%d enemies: Overmind took %.3f ms per frame, limit is %.3f ms"), Stage.EnemyCount, TotalMilliseconds, Stage.MaxOvermindMilliseconds));
+		bPassed = false;
+	}
+	if (Stage.MaxSpawnLatency > 0.0f && Timings.WorstSpawnLatency > Stage.MaxSpawnLatency)
+	{
+		AddError(FString::Printf(TEXT("%d enemies: Worst spawn latency %.3f s, limit is %.3f s"), Stage.EnemyCount, Timings.WorstSpawnLatency, Stage.MaxSpawnLatency));
+		bPassed = false;
+	}
+	if (Stage.MaxMemoryMegabytes > 0.0f && MemoryMegabytes > Stage.MaxMemoryMegabytes)
+	{
+		AddError(FString::Printf(TEXT("%d enemies: Using %.1f MB, limit is %.1f MB"), Stage.EnemyCount, MemoryMegabytes, Stage.MaxMemoryMegabytes));
+		bPassed = false;
+	}
+	if (Stage.MaxGarbageCollectionMilliseconds > 0.0f && GarbageCollectionMilliseconds > Stage.MaxGarbageCollectionMilliseconds)
+	{
+		AddError(FString::Printf(TEXT("%d enemies: Garbage collection took %.3f ms, limit is %.3f ms"), Stage.EnemyCount, GarbageCollectionMilliseconds, Stage.MaxGarbageCollectionMilliseconds));
+		bPassed = false;
+	}
+	if (Stage.bCheckArenaHeapAllocations && ArenaHeapAllocations > 0)
+	{
+		AddError(FString::Printf(TEXT("%d enemies: Frame arena went to the heap %llu times after warming up"), Stage.EnemyCount, ArenaHeapAllocations));
+		bPassed = false;
+	}
+
+	CsvLines.Add(FString::Printf(TEXT("%d,%s,%s,%d,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%llu,%llu,%llu,%llu,%.4f,%.1f,%s"),
+		Stage.EnemyCount, Stage.bGenericLoops ? TEXT("generic") : TEXT("specialized"), Stage.bClusterPool ? TEXT("clustered") : TEXT("plain"), Overmind->GetNumActiveEnemies(), Frames,
+		PhaseMilliseconds[(uint8)EOvermindPhase::Cooldowns], PhaseMilliseconds[(uint8)EOvermindPhase::GroupLocation],
+		PhaseMilliseconds[(uint8)EOvermindPhase::Vision], PhaseMilliseconds[(uint8)EOvermindPhase::DistanceCheck],
+		PhaseMilliseconds[(uint8)EOvermindPhase::ActionPicking], PhaseMilliseconds[(uint8)EOvermindPhase::Spawn],
+		PhaseMilliseconds[(uint8)EOvermindPhase::Crowd], PhaseMilliseconds[(uint8)EOvermindPhase::Separation],
+		PhaseMilliseconds[(uint8)EOvermindPhase::Activation], Timings.WorstActivationMilliseconds,
+		PhaseMilliseconds[(uint8)EOvermindPhase::MobAI], PhaseMilliseconds[(uint8)EOvermindPhase::Pipeline],
+		TotalMilliseconds, AverageLatency, Timings.WorstSpawnLatency,
+		Timings.NumRangeDespawns - StartTimings.NumRangeDespawns, Timings.NumChurnedSpawns - StartTimings.NumChurnedSpawns,
+		Timings.NumRecycles - StartTimings.NumRecycles, ArenaHeapAllocations, GarbageCollectionMilliseconds, MemoryMegabytes, bPassed ? TEXT("true") : TEXT("false")));
+
+	return bPassed;
+}
+
+float AOvermindPerformanceTest::MeasureGarbageCollection()
+{
+	// The first one also collects whatever the stage left behind, it is not counted.
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	const int32 NumCollections = 3;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumCollections; ++i)
+	{
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	}
+	return (float)((FPlatformTime::Seconds() - StartTime) * 1000.0 / NumCollections);
+}
+
+void AOvermindPerformanceTest::MoveBots(float DeltaSeconds)
+{
+	// Walk the circle so enemies keep having to chase, spawn and despawn.
+	BotAngle += (BotSpeed * DeltaSeconds) / FMath::Max(BotPathRadius, 1.0f);
+	for (int32 i = 0; i < Bots.Num(); ++i)
+	{
+		if (!Bots[i])
+		{
+			continue;
+		}
+		const float Angle = BotAngle + (2.0f * PI * i) / Bots.Num();
+		FVector Location = GetActorLocation() + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * BotPathRadius;
+		Location.Z = Bots[i]->GetActorLocation().Z;
+		Bots[i]->SetActorLocation(Location, true);
+	}
+}
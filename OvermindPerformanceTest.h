@@ -0,0 +1,138 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FunctionalTest.h"
+#include "OvermindRecorder.h"
+#include "OvermindPerformanceTest.generated.h"
+
+class AANephilimBase;
+class AOvermindBase;
+
+// One step of the ramp: how many enemies to have on the map and how much they are allowed to cost.
+USTRUCT(BlueprintType)
+struct FOvermindPerformanceStage
+{
+	GENERATED_BODY()
+
+	FOvermindPerformanceStage() : EnemyCount(50), MaxOvermindMilliseconds(1.0f), MaxSpawnLatency(1.0f), MaxMemoryMegabytes(0.0f), MaxGarbageCollectionMilliseconds(0.0f), bCheckArenaHeapAllocations(true), bGenericLoops(false), bClusterPool(false)
+	{
+
+	}
+
+	// Enemies the pool is grown to and spawned before measuring.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		int32 EnemyCount;
+
+	// Test fails if the Overmind takes longer than this on average per frame, all phases together.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxOvermindMilliseconds;
+
+	// Test fails if enemies take longer than this (seconds) from being asked for to being on the map.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxSpawnLatency;
+
+	// Test fails if the process uses more memory than this, 0 to not check.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxMemoryMegabytes;
+
+	// Test fails if a full garbage collection takes longer than this at the end of the stage, 0 to not check.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxGarbageCollectionMilliseconds;
+
+	// Test fails if the frame arena goes to the heap while measuring, the ramp has warmed it up by then.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		bool bCheckArenaHeapAllocations;
+
+	// Measure with the Overmind's unspecialized loops, repeat a stage with and without to compare them.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		bool bGenericLoops;
+
+	// Keep the enemy pool in a garbage collection cluster (bClusterEnemyPool), repeat a stage with and without to compare collections.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+		bool bClusterPool;
+};
+
+/**
+ * Functional test that ramps an Overmind through several enemy counts with scripted bot players walking around,
+ * measuring game thread time of every Overmind phase, spawn latency and memory. Results are written to
+ * Saved/Automation/OvermindPerformance_<Date>.csv and the test fails when a stage goes over its thresholds.
+ * Place it on a test map with an Overmind and run it headless, see README.
+ */
+UCLASS()
+class NIGHTFALL_API AOvermindPerformanceTest : public AFunctionalTest
+{
+	GENERATED_BODY()
+
+public:
+	AOvermindPerformanceTest();
+
+	// Overmind under test.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		AOvermindBase* Overmind;
+
+	// Bots used as players, they walk in circles around the test.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		TSubclassOf<AANephilimBase> BotClass;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test", meta = (ClampMin = "1", UIMin = "1"))
+		int32 NumBots;
+
+	// Radius of the circle the bots walk on.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float BotPathRadius;
+
+	// Speed of the bots in unreal units per second.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float BotSpeed;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		TArray<FOvermindPerformanceStage> Stages;
+
+	// Seconds given to each stage to get its enemies on the map.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float RampTime;
+
+	// Seconds each stage is measured for.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float MeasureTime;
+
+	virtual void StartTest() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+
+	enum class EStep : uint8
+	{
+		Ramp,
+		Measure,
+		Done
+	};
+
+	// Grow the pool and ask for the enemies of the current stage.
+	void BeginStage();
+
+	// Write the measurements of the current stage and check its thresholds, false if it failed.
+	bool EndStage();
+
+	// Average milliseconds of a few full garbage collections.
+	static float MeasureGarbageCollection();
+
+	void MoveBots(float DeltaSeconds);
+
+	TArray<AANephilimBase*> Bots;
+	int32 StageIndex;
+	EStep Step;
+	float StepTime;
+	float BotAngle;
+
+	// Overmind numbers when the measure started, the stage result is the difference.
+	FOvermindPhaseTimings StartTimings;
+	// Same when the stage started, for the spawns made during the ramp.
+	FOvermindPhaseTimings StageStartTimings;
+
+	FString CsvFileName;
+	TArray<FString> CsvLines;
+	bool bAnyStageFailed;
+};
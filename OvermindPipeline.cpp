@@ -0,0 +1,347 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindPipeline.h"
+#include "OvermindVoxelGrid.h"
+
+FOvermindPipeline::FOvermindPipeline() : WriteIndex(0), bResultsReady(false)
+{
+	Results.AverageGroupLocation = FVector::ZeroVector;
+}
+
+FOvermindPipeline::~FOvermindPipeline()
+{
+	WaitForTask();
+}
+
+void FOvermindPipeline::Kick(bool bUseWorkerThread)
+{
+	WaitForTask();
+	const FOvermindFrameSnapshot* Snapshot = &Snapshots[WriteIndex];
+	WriteIndex ^= 1;
+	bResultsReady = true;
+	if (!bUseWorkerThread)
+	{
+		Run(*Snapshot);
+		return;
+	}
+
+	Task = FFunctionGraphTask::CreateAndDispatchWhenReady([this, Snapshot]()
+	{
+		Run(*Snapshot);
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+bool FOvermindPipeline::Sync()
+{
+	WaitForTask();
+	const bool bReady = bResultsReady;
+	bResultsReady = false;
+	return bReady;
+}
+
+void FOvermindPipeline::WaitForTask()
+{
+	if (Task.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task);
+		Task = nullptr;
+	}
+}
+
+void FOvermindPipeline::Reset()
+{
+	WaitForTask();
+	bResultsReady = false;
+	PlayerCells.Reset();
+	Results = FOvermindFrameResults();
+	Results.AverageGroupLocation = FVector::ZeroVector;
+}
+
+void FOvermindPipeline::Run(const FOvermindFrameSnapshot& Snapshot)
+{
+	Results.VisionCandidates.Reset();
+	Results.OutOfRange.Reset();
+	Results.Demotions.Reset();
+	Results.TargetDistances.Reset();
+	Results.LostTargets.Reset();
+
+	// =============== Group location ===============
+
+	const int32 NumPlayers = Snapshot.PlayerLocations.Num();
+	int32 NumValid = 0;
+	FVector Sum = FVector::ZeroVector;
+	bool bPlayerMoved = false;
+	if (PlayerCells.Num() != NumPlayers)
+	{
+		// Players joined or left, start over.
+		PlayerCells.Init(FIntVector(MAX_int32), NumPlayers);
+		Results.PlayerClusters.Reset();
+		Results.PlayerClusterIndex.Init(INDEX_NONE, NumPlayers);
+	}
+
+	// Cells players left and entered this frame, only enemies around them get a look.
+	struct FPlayerMove
+	{
+		FIntVector OldCell;
+		FIntVector NewCell;
+	};
+	TArray<FPlayerMove, TInlineAllocator<4>> Moves;
+	bool bCheckAll = false;
+	for (int32 i = 0; i < NumPlayers; ++i)
+	{
+		if (!Snapshot.ValidPlayers[i])
+		{
+			continue;
+		}
+		const FVector& Location = Snapshot.PlayerLocations[i];
+		Sum += Location;
+		++NumValid;
+
+		const FIntVector Cell = GetCell(Location, Snapshot.GridCellSize);
+		if (Cell != PlayerCells[i])
+		{
+			// First time this player is seen, nothing to compare against.
+			bCheckAll |= PlayerCells[i].X == MAX_int32;
+			Moves.Add({ PlayerCells[i], Cell });
+			PlayerCells[i] = Cell;
+			bPlayerMoved = true;
+		}
+	}
+	if (NumValid > 0)
+	{
+		Results.AverageGroupLocation = Sum / NumValid;
+	}
+
+	// A player walked into another cell. Its cluster moved so every enemy's range is measured again (just distances),
+	// but only enemies that could see it where it was or where it is now look for it.
+	if (bPlayerMoved)
+	{
+		UpdatePlayerClusters(Snapshot.PlayerLocations, [&Snapshot](int32 Player) { return Snapshot.ValidPlayers[Player]; },
+			Snapshot.PlayerClusterRadius, Results.PlayerClusters, Results.PlayerClusterIndex);
+	}
+	auto CanSeeMove = [&](const FOvermindEnemyState& Enemy)
+	{
+		if (bCheckAll)
+		{
+			return true;
+		}
+		const FIntVector EnemyCell = GetCell(Enemy.Location, Snapshot.GridCellSize);
+		for (const FPlayerMove& Move : Moves)
+		{
+			if (CanSeePlayerMove(EnemyCell, Enemy.SightRadius, Move.OldCell, Move.NewCell, Snapshot.GridCellSize))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// =============== Range ===============
+
+	const float KillRangeSquared = Snapshot.KillEnemyRange * Snapshot.KillEnemyRange;
+	const float DemoteRangeSquared = Snapshot.ProxyDemoteRange * Snapshot.ProxyDemoteRange;
+	for (int32 i = 0; i < Snapshot.Enemies.Num(); ++i)
+	{
+		const FOvermindEnemyState& Enemy = Snapshot.Enemies[i];
+		if (!Enemy.bActive || (!bPlayerMoved && !Snapshot.RangeDirty[i]))
+		{
+			continue;
+		}
+
+		// Measured against the closest group of players, an enemy next to a player who wandered off is not too far.
+		float ClosestSquared = Results.PlayerClusters.Num() > 0 ? MAX_flt : FVector::DistSquared(Enemy.Location, Results.AverageGroupLocation);
+		for (const FOvermindPlayerCluster& Cluster : Results.PlayerClusters)
+		{
+			ClosestSquared = FMath::Min(ClosestSquared, FVector::DistSquared(Enemy.Location, Cluster.Center));
+		}
+		if (ClosestSquared > KillRangeSquared)
+		{
+			Results.OutOfRange.Add({ i, Enemy.Generation, FMath::Sqrt(ClosestSquared) });
+			continue;
+		}
+
+		if (Snapshot.ProxyDemoteRange > 0.0f && !Enemy.bInCombat)
+		{
+			float ClosestPlayerSquared = MAX_flt;
+			for (int32 p = 0; p < NumPlayers; ++p)
+			{
+				if (Snapshot.ValidPlayers[p])
+				{
+					ClosestPlayerSquared = FMath::Min(ClosestPlayerSquared, FVector::DistSquared(Enemy.Location, Snapshot.PlayerLocations[p]));
+				}
+			}
+			if (ClosestPlayerSquared > DemoteRangeSquared)
+			{
+				Results.Demotions.Add({ i, Enemy.Generation, FMath::Sqrt(ClosestPlayerSquared) });
+			}
+		}
+	}
+
+	// =============== Vision ===============
+
+	for (int32 i = 0; i < Snapshot.Enemies.Num(); ++i)
+	{
+		const FOvermindEnemyState& Enemy = Snapshot.Enemies[i];
+		if (!Enemy.bActive || Enemy.bInCombat || (!Snapshot.VisionDirty[i] && (!bPlayerMoved || !CanSeeMove(Enemy))))
+		{
+			continue;
+		}
+
+		const int32 FirstCandidate = Results.VisionCandidates.Num();
+		for (int32 p = 0; p < NumPlayers; ++p)
+		{
+			if (!Snapshot.TargetablePlayers[p])
+			{
+				continue;
+			}
+
+			// Close enough and in front of the enemy.
+			const FVector ToPlayer = Snapshot.PlayerLocations[p] - Enemy.Location;
+			const float Distance = ToPlayer.Size();
+			if (Distance > Enemy.SightRadius || FVector::DotProduct(Enemy.Forward, ToPlayer) < 0.0f)
+			{
+				continue;
+			}
+			if (Snapshot.VisionGrid && !Snapshot.VisionGrid->HasLineOfSight(Enemy.Location, Snapshot.PlayerLocations[p]))
+			{
+				continue;
+			}
+			Results.VisionCandidates.Add({ i, Enemy.Generation, p, Distance });
+		}
+
+		// Closest first, the game thread takes the first one that passes its trace.
+		const int32 NumCandidates = Results.VisionCandidates.Num() - FirstCandidate;
+		if (NumCandidates > 1)
+		{
+			Sort(Results.VisionCandidates.GetData() + FirstCandidate, NumCandidates, [](const FOvermindVisionCandidate& A, const FOvermindVisionCandidate& B)
+			{
+				return A.Distance < B.Distance;
+			});
+		}
+	}
+
+	// =============== Target distances ===============
+
+	for (int32 i = 0; i < Snapshot.Enemies.Num(); ++i)
+	{
+		const FOvermindEnemyState& Enemy = Snapshot.Enemies[i];
+		if (!Enemy.bActive || !Enemy.bHasTarget)
+		{
+			continue;
+		}
+
+		const float Distance = FVector::Dist(Enemy.TargetLocation, Enemy.Location);
+		Results.TargetDistances.Add({ i, Enemy.Generation, Distance });
+		// Loose track of target if it is farther than 150% of sight radius.
+		if (Enemy.bInCombat && Distance > Enemy.SightRadius * 1.5f)
+		{
+			Results.LostTargets.Add({ i, Enemy.Generation, Distance });
+		}
+	}
+}
+
+void FOvermindPipeline::UpdatePlayerClusters(TArrayView<const FVector> PlayerLocations, TFunctionRef<bool(int32)> IsValidPlayer, float Radius,
+	TArray<FOvermindPlayerCluster>& Clusters, TArray<int32>& ClusterIndex)
+{
+	const float RadiusSquared = Radius * Radius;
+
+	// Players that stayed close to their cluster keep it, the others join the closest cluster in range or start their own.
+	for (int32 i = 0; i < PlayerLocations.Num(); ++i)
+	{
+		if (!IsValidPlayer(i))
+		{
+			ClusterIndex[i] = INDEX_NONE;
+			continue;
+		}
+
+		const FVector Location = PlayerLocations[i];
+		int32 Cluster = ClusterIndex[i];
+		if (Clusters.IsValidIndex(Cluster) && FVector::DistSquared(Clusters[Cluster].Center, Location) <= RadiusSquared)
+		{
+			continue;
+		}
+
+		Cluster = INDEX_NONE;
+		float ClosestSquared = RadiusSquared;
+		for (int32 c = 0; c < Clusters.Num(); ++c)
+		{
+			const float DistanceSquared = FVector::DistSquared(Clusters[c].Center, Location);
+			if (DistanceSquared <= ClosestSquared)
+			{
+				ClosestSquared = DistanceSquared;
+				Cluster = c;
+			}
+		}
+		if (Cluster == INDEX_NONE)
+		{
+			FOvermindPlayerCluster NewCluster;
+			NewCluster.Center = Location;
+			NewCluster.NumPlayers = 0;
+			Cluster = Clusters.Add(NewCluster);
+		}
+		ClusterIndex[i] = Cluster;
+	}
+
+	// Recenter every cluster on its players.
+	for (FOvermindPlayerCluster& Cluster : Clusters)
+	{
+		Cluster.Center = FVector::ZeroVector;
+		Cluster.NumPlayers = 0;
+	}
+	for (int32 i = 0; i < PlayerLocations.Num(); ++i)
+	{
+		if (ClusterIndex[i] != INDEX_NONE)
+		{
+			Clusters[ClusterIndex[i]].Center += PlayerLocations[i];
+			Clusters[ClusterIndex[i]].NumPlayers++;
+		}
+	}
+	for (FOvermindPlayerCluster& Cluster : Clusters)
+	{
+		if (Cluster.NumPlayers > 0)
+		{
+			Cluster.Center /= Cluster.NumPlayers;
+		}
+	}
+
+	// Clusters that came back together merge into the first one, empty clusters go away.
+	for (int32 a = 0; a < Clusters.Num(); ++a)
+	{
+		for (int32 b = a + 1; b < Clusters.Num(); ++b)
+		{
+			if (Clusters[a].NumPlayers == 0 || Clusters[b].NumPlayers == 0 ||
+				FVector::DistSquared(Clusters[a].Center, Clusters[b].Center) > RadiusSquared)
+			{
+				continue;
+			}
+
+			const int32 Total = Clusters[a].NumPlayers + Clusters[b].NumPlayers;
+			Clusters[a].Center = (Clusters[a].Center * Clusters[a].NumPlayers + Clusters[b].Center * Clusters[b].NumPlayers) / Total;
+			Clusters[a].NumPlayers = Total;
+			Clusters[b].NumPlayers = 0;
+			for (int32& PlayerCluster : ClusterIndex)
+			{
+				if (PlayerCluster == b)
+				{
+					PlayerCluster = a;
+				}
+			}
+		}
+	}
+	for (int32 c = Clusters.Num() - 1; c >= 0; --c)
+	{
+		if (Clusters[c].NumPlayers > 0)
+		{
+			continue;
+		}
+		Clusters.RemoveAt(c);
+		for (int32& PlayerCluster : ClusterIndex)
+		{
+			if (PlayerCluster > c)
+			{
+				PlayerCluster--;
+			}
+		}
+	}
+}
@@ -0,0 +1,161 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+
+class FOvermindVoxelGrid;
+
+// Players standing close to each other, enemies are kept and spawned around clusters instead of around everyone's average.
+struct FOvermindPlayerCluster
+{
+	FVector Center;
+	int32 NumPlayers;
+};
+
+// One slot of the enemy pool as the worker sees it.
+struct FOvermindEnemyState
+{
+	FVector Location;
+	FVector Forward;
+	// Only meaningful with bHasTarget.
+	FVector TargetLocation;
+	float SightRadius;
+	// Changes every time the slot is placed, moved by a recycle or released, so stale results can be told apart.
+	uint32 Generation;
+	bool bActive;
+	bool bInCombat;
+	bool bHasTarget;
+};
+
+// Everything the worker pass reads, copied from the actors at the start of a frame.
+struct FOvermindFrameSnapshot
+{
+	TArray<FVector> PlayerLocations;
+	// Players that exist, and the ones of them enemies can target.
+	TBitArray<> ValidPlayers;
+	TBitArray<> TargetablePlayers;
+
+	// One entry per slot of EnemyArray.
+	TArray<FOvermindEnemyState> Enemies;
+	// Dirty sets of the Overmind at the time of the snapshot, the Overmind starts new ones.
+	TBitArray<> VisionDirty;
+	TBitArray<> RangeDirty;
+
+	float GridCellSize;
+	float KillEnemyRange;
+	float PlayerClusterRadius;
+	// 0 when enemies are never demoted to proxies.
+	float ProxyDemoteRange;
+	// Static line of sight, null to leave every sight check to the game thread traces.
+	const FOvermindVoxelGrid* VisionGrid;
+};
+
+// Player an enemy could target, closest candidates of an enemy come first.
+struct FOvermindVisionCandidate
+{
+	int32 Slot;
+	uint32 Generation;
+	int32 Player;
+	float Distance;
+};
+
+// Enemy slot with a distance, for range despawns and target tracking.
+struct FOvermindSlotDistance
+{
+	int32 Slot;
+	uint32 Generation;
+	float Distance;
+};
+
+// What the worker decided, applied by the Overmind on the game thread one frame later.
+struct FOvermindFrameResults
+{
+	FVector AverageGroupLocation;
+	TArray<FOvermindPlayerCluster> PlayerClusters;
+	TArray<int32> PlayerClusterIndex;
+
+	TArray<FOvermindVisionCandidate> VisionCandidates;
+	TArray<FOvermindSlotDistance> OutOfRange;
+	TArray<FOvermindSlotDistance> Demotions;
+	// Distance of every enemy with a target to it, and the ones that lost track.
+	TArray<FOvermindSlotDistance> TargetDistances;
+	TArray<FOvermindSlotDistance> LostTargets;
+};
+
+/**
+ * Group location, vision, and range checks of the Overmind, run as a task on a worker thread.
+ * The game thread fills a snapshot at the start of a frame and the worker decides on it while the frame goes on.
+ * At the next frame's sync point the results are applied and the next snapshot is handed over. Snapshots are
+ * double buffered, so the next one can be filled while the worker still reads the last one.
+ */
+class NIGHTFALL_API FOvermindPipeline
+{
+public:
+	FOvermindPipeline();
+	~FOvermindPipeline();
+
+	// Snapshot to fill this frame, the worker never reads it before Kick.
+	FOvermindFrameSnapshot& GetWriteSnapshot()
+	{
+		return Snapshots[WriteIndex];
+	}
+
+	// Start deciding on the snapshot just filled.
+	void Kick(bool bUseWorkerThread);
+
+	// Wait for the task started by the last Kick, true if it left results nobody synced on yet. Results stay valid until the next Kick.
+	bool Sync();
+
+	const FOvermindFrameResults& GetResults() const
+	{
+		return Results;
+	}
+
+	// Wait for the worker and forget the clusters and player cells, for a restart.
+	void Reset();
+
+	/**
+	* Keep players in the clusters they were in while they stay close, move them around when they split or regroup.
+	* Shared with the Overmind's game thread path.
+	*/
+	static void UpdatePlayerClusters(TArrayView<const FVector> PlayerLocations, TFunctionRef<bool(int32)> IsValidPlayer, float Radius,
+		TArray<FOvermindPlayerCluster>& Clusters, TArray<int32>& ClusterIndex);
+
+	static FIntVector GetCell(const FVector& Location, float CellSize)
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	// Cells apart along the axis they are the furthest apart on.
+	static int32 CellDistance(const FIntVector& A, const FIntVector& B)
+	{
+		return FMath::Max3(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y), FMath::Abs(A.Z - B.Z));
+	}
+
+	/**
+	* A player walked from OldCell to NewCell, could an enemy in EnemyCell see either of them.
+	* One extra cell since both can stand anywhere in their cells. Shared with the Overmind's game thread path.
+	*/
+	static bool CanSeePlayerMove(const FIntVector& EnemyCell, float SightRadius, const FIntVector& OldCell, const FIntVector& NewCell, float CellSize)
+	{
+		const int32 SightCells = FMath::CeilToInt(SightRadius / CellSize) + 1;
+		return CellDistance(EnemyCell, OldCell) <= SightCells || CellDistance(EnemyCell, NewCell) <= SightCells;
+	}
+
+private:
+
+	void Run(const FOvermindFrameSnapshot& Snapshot);
+
+	void WaitForTask();
+
+	FOvermindFrameSnapshot Snapshots[2];
+	int32 WriteIndex;
+	FOvermindFrameResults Results;
+	FGraphEventRef Task;
+	bool bResultsReady;
+
+	// Only touched by the worker while a task runs.
+	TArray<FIntVector> PlayerCells;
+};
@@ -0,0 +1,154 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OvermindBase.h"
+
+/**
+ * Strategies the hot loops of the Overmind are compiled for.
+ * A loop takes its policies as template parameters and AOvermindBase picks the instantiation matching its settings
+ * once per frame, so settings are not branched on for every enemy and the policy calls inline into the loop.
+ * The Runtime policies look at the settings on every call, that is the loop as it was before, kept to benchmark against.
+ */
+struct FOvermindPolicies
+{
+	// =============== Vision: an enemy has a player in sight range and in front of it, can it see the player? ===============
+
+	// Physics traces against everything.
+	struct FTraceVision
+	{
+		static FORCEINLINE bool CanSee(AOvermindBase& Overmind, int32 Enemy, int32 Player, const FVector& From, const FVector& To)
+		{
+			return Overmind.TraceToPlayer(Enemy, Player, false);
+		}
+	};
+
+	// Voxel grid for the level, traces only for what moves.
+	struct FVoxelTraceVision
+	{
+		static FORCEINLINE bool CanSee(AOvermindBase& Overmind, int32 Enemy, int32 Player, const FVector& From, const FVector& To)
+		{
+			return Overmind.VisionGrid->HasLineOfSight(From, To) && Overmind.TraceToPlayer(Enemy, Player, true);
+		}
+	};
+
+	// Voxel grid only, nothing that moves blocks sight.
+	struct FVoxelVision
+	{
+		static FORCEINLINE bool CanSee(AOvermindBase& Overmind, int32 Enemy, int32 Player, const FVector& From, const FVector& To)
+		{
+			return Overmind.VisionGrid->HasLineOfSight(From, To) && Overmind.PlayerArray[Player]->Team == ETeams::Player;
+		}
+	};
+
+	struct FRuntimeVision
+	{
+		static bool CanSee(AOvermindBase& Overmind, int32 Enemy, int32 Player, const FVector& From, const FVector& To)
+		{
+			const bool bVoxelSight = Overmind.UsesVoxelLineOfSight();
+			if (bVoxelSight && !Overmind.VisionGrid->HasLineOfSight(From, To))
+			{
+				return false;
+			}
+			if (bVoxelSight && !Overmind.bTraceDynamicOccluders)
+			{
+				return Overmind.PlayerArray[Player]->Team == ETeams::Player;
+			}
+			return Overmind.TraceToPlayer(Enemy, Player, bVoxelSight);
+		}
+	};
+
+	// =============== Target selection: which of the players an enemy can see does it go after? ===============
+
+	// The closest one. Players farther than the best so far are not even checked for sight.
+	struct FClosestTarget
+	{
+		int32 Player = INDEX_NONE;
+		float Distance = MAX_flt;
+
+		FORCEINLINE bool Wants(int32 InPlayer, float InDistance) const
+		{
+			return InDistance < Distance;
+		}
+
+		FORCEINLINE void Offer(int32 InPlayer, float InDistance)
+		{
+			Player = InPlayer;
+			Distance = InDistance;
+		}
+	};
+
+	// =============== Despawn: an enemy is past KillEnemyRange ===============
+
+	// Back to the pool.
+	struct FReleaseDespawn
+	{
+		FORCEINLINE void Despawn(AOvermindBase& Overmind, int32 Enemy)
+		{
+			Overmind.ReleaseOutOfRange(Enemy);
+		}
+	};
+
+	// Moved to a new spawn point, back to the pool if there is none.
+	struct FRecycleDespawn
+	{
+		// Built for the first enemy that needs it, shared by the others of the pass.
+		bool bQueryBuilt = false;
+		bool bCanRecycle = false;
+
+		void Despawn(AOvermindBase& Overmind, int32 Enemy)
+		{
+			if (!bQueryBuilt)
+			{
+				bQueryBuilt = true;
+				bCanRecycle = Overmind.BuildSpawnQuery(Overmind.SpawnQuery);
+			}
+			if (!bCanRecycle || !Overmind.RecycleEnemy(Enemy, Overmind.SpawnQuery))
+			{
+				Overmind.ReleaseOutOfRange(Enemy);
+			}
+		}
+	};
+
+	struct FRuntimeDespawn : FRecycleDespawn
+	{
+		void Despawn(AOvermindBase& Overmind, int32 Enemy)
+		{
+			if (Overmind.bRecycleOutOfRangeEnemies)
+			{
+				FRecycleDespawn::Despawn(Overmind, Enemy);
+			}
+			else
+			{
+				Overmind.ReleaseOutOfRange(Enemy);
+			}
+		}
+	};
+
+	// =============== Demotion: does an idle enemy far from every player go back to being a crowd proxy? ===============
+
+	struct FNoDemotion
+	{
+		static FORCEINLINE bool IsEnabled(const AOvermindBase& Overmind)
+		{
+			return false;
+		}
+	};
+
+	struct FProxyDemotion
+	{
+		static FORCEINLINE bool IsEnabled(const AOvermindBase& Overmind)
+		{
+			return true;
+		}
+	};
+
+	struct FRuntimeDemotion
+	{
+		static FORCEINLINE bool IsEnabled(const AOvermindBase& Overmind)
+		{
+			return Overmind.bUseCrowdProxies;
+		}
+	};
+};
@@ -0,0 +1,42 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindPoolCluster.h"
+#include "EnemyBase.h"
+#include "UObject/UObjectArray.h"
+
+int32 UOvermindPoolCluster::Build(const TArray<AEnemyBase*>& InEnemies)
+{
+	Dissolve();
+
+	Enemies.Reset(InEnemies.Num());
+	for (AEnemyBase* Enemy : InEnemies)
+	{
+		if (IsValid(Enemy) && Enemy->CanBeInCluster())
+		{
+			Enemies.Add(Enemy);
+		}
+	}
+
+	CreateCluster();
+	return GetNumClusteredObjects();
+}
+
+void UOvermindPoolCluster::Dissolve()
+{
+	if (HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot))
+	{
+		GUObjectClusters.DissolveCluster(this);
+	}
+	Enemies.Reset();
+}
+
+int32 UOvermindPoolCluster::GetNumClusteredObjects() const
+{
+	if (!HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot))
+	{
+		return 0;
+	}
+	const FUObjectItem* RootItem = GUObjectArray.ObjectToObjectItem(this);
+	return GUObjectClusters[RootItem->GetClusterIndex()].Objects.Num() + 1;
+}
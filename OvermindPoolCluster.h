@@ -0,0 +1,44 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "OvermindPoolCluster.generated.h"
+
+class AEnemyBase;
+
+/**
+ * Root of a garbage collection cluster made of the pooled enemies of an Overmind and their components.
+ * The pool lives as long as the level, so the whole cluster is kept or dropped as one and reachability analysis
+ * does not walk every enemy on every pass. References of the enemies to things outside the cluster are taken
+ * when it is built, so the Overmind builds it again whenever the pool changes, and dissolves it before an enemy is destroyed.
+ */
+UCLASS()
+class NIGHTFALL_API UOvermindPoolCluster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool CanBeClusterRoot() const override
+	{
+		return true;
+	}
+
+	/**
+	* Cluster the enemies that can be in one (see AEnemyBase::CanBeInCluster), with everything they own.
+	* @return	How many objects ended up in the cluster, root included. 0 if the engine did not make one.
+	*/
+	int32 Build(const TArray<AEnemyBase*>& InEnemies);
+
+	// Split the cluster, its objects go back to being looked at one by one.
+	void Dissolve();
+
+	int32 GetNumClusteredObjects() const;
+
+private:
+
+	// What the cluster is built from, the engine follows the root's references.
+	UPROPERTY()
+		TArray<AEnemyBase*> Enemies;
+};
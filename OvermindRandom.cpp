@@ -0,0 +1,30 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindRandom.h"
+
+void FOvermindRandom::Seed(uint64 InSeed, uint64 Stream)
+{
+	BaseSeed = InSeed;
+	State = 0;
+	Increment = (Stream << 1u) | 1u;
+	NextUInt32();
+	State += InSeed;
+	NextUInt32();
+}
+
+void FOvermindRandom::FillUInt32(uint32* Out, int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Out[i] = NextUInt32();
+	}
+}
+
+void FOvermindRandom::FillFloats(float* Out, int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Out[i] = NextFloat();
+	}
+}
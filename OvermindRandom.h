@@ -0,0 +1,84 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Small seedable generator (PCG32, XSH RR) owned by an Overmind, its enemies and its worker tasks.
+ * Same seed and stream always give the same numbers, and each stream of a seed is a distinct sequence,
+ * so every enemy and every worker can have its own generator without locks and runs can be replayed exactly.
+ * Distinct is all PCG promises, streams are not guaranteed to be statistically independent of each other.
+ */
+class NIGHTFALL_API FOvermindRandom
+{
+public:
+	FOvermindRandom()
+	{
+		Seed(0, 0);
+	}
+
+	FOvermindRandom(uint64 InSeed, uint64 Stream)
+	{
+		Seed(InSeed, Stream);
+	}
+
+	// Restart the generator on this seed and stream.
+	void Seed(uint64 InSeed, uint64 Stream);
+
+	// Generator with the same seed as this one on another stream, a different sequence from this one's.
+	FOvermindRandom Substream(uint64 Stream) const
+	{
+		return FOvermindRandom(BaseSeed, Stream);
+	}
+
+	FORCEINLINE uint32 NextUInt32()
+	{
+		const uint64 OldState = State;
+		State = OldState * 6364136223846793005ull + Increment;
+		const uint32 XorShifted = (uint32)(((OldState >> 18u) ^ OldState) >> 27u);
+		const uint32 Rotation = (uint32)(OldState >> 59u);
+		return (XorShifted >> Rotation) | (XorShifted << ((0u - Rotation) & 31u));
+	}
+
+	// [0, 1)
+	FORCEINLINE float NextFloat()
+	{
+		// 24 bits is all a float can hold.
+		return (NextUInt32() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// [Min, Max)
+	FORCEINLINE float RandRange(float Min, float Max)
+	{
+		return Min + (Max - Min) * NextFloat();
+	}
+
+	// [Min, Max], both included.
+	FORCEINLINE int32 RandRange(int32 Min, int32 Max)
+	{
+		const uint64 Range = (uint64)((int64)Max - (int64)Min) + 1;
+		return Min + (int32)(((uint64)NextUInt32() * Range) >> 32);
+	}
+
+	// Batch versions, for drawing the numbers a whole pass needs at once.
+	void FillUInt32(uint32* Out, int32 Count);
+	void FillFloats(float* Out, int32 Count);
+
+	uint64 GetSeed() const
+	{
+		return BaseSeed;
+	}
+
+	// Whole state, a generator loaded back carries on with the exact same numbers.
+	friend FArchive& operator<<(FArchive& Ar, FOvermindRandom& Random)
+	{
+		return Ar << Random.State << Random.Increment << Random.BaseSeed;
+	}
+
+private:
+	uint64 State;
+	// Odd, picks the stream.
+	uint64 Increment;
+	uint64 BaseSeed;
+};
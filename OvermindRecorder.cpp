@@ -0,0 +1,133 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindRecorder.h"
+#include "OvermindBase.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+
+FOvermindRecorder::FOvermindRecorder(const FString& InFileName, int32 CapacityPow2) :
+	FileName(InFileName), Writer(nullptr), Thread(nullptr), WriteIndex(0), ReadIndex(0), bStopping(false), Frame(0), NumDropped(0)
+{
+	const uint32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(CapacityPow2, 1024));
+	Buffer.SetNumZeroed(Capacity);
+	Mask = Capacity - 1;
+}
+
+FOvermindRecorder::~FOvermindRecorder()
+{
+	StopRecording();
+}
+
+bool FOvermindRecorder::StartRecording()
+{
+	Writer = IFileManager::Get().CreateFileWriter(*FileName);
+	if (!Writer)
+	{
+		UE_LOG(LogOvermind, Warning, TEXT("Overmind: Could not create recording %s"), *FileName);
+		return false;
+	}
+
+	FOvermindRecordHeader Header;
+	Header.Magic = FOvermindRecordHeader::ExpectedMagic;
+	Header.Version = FOvermindRecordHeader::CurrentVersion;
+	Header.RecordSize = sizeof(FOvermindRecord);
+	Writer->Serialize(&Header, sizeof(Header));
+
+	Thread = FRunnableThread::Create(this, TEXT("OvermindRecorder"), 0, TPri_BelowNormal);
+	return true;
+}
+
+void FOvermindRecorder::StopRecording()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (Writer)
+	{
+		Drain();
+		Writer->Close();
+		delete Writer;
+		Writer = nullptr;
+
+		if (NumDropped > 0)
+		{
+			UE_LOG(LogOvermind, Warning, TEXT("Overmind: Recording %s dropped %u records, buffer too small?"), *FileName, NumDropped);
+		}
+	}
+}
+
+void FOvermindRecorder::BeginFrame(float WorldTime)
+{
+	++Frame;
+	Record(EOvermindRecordType::FrameBegin, -1, FVector::ZeroVector, WorldTime);
+}
+
+void FOvermindRecorder::Record(EOvermindRecordType Type, int32 Slot, const FVector& Location, float Value, uint8 Aux)
+{
+	const uint64 Head = WriteIndex.Load(EMemoryOrder::Relaxed);
+	if (Head - ReadIndex.Load() > Mask)
+	{
+		// Writer thread is behind, better lose a record than stall the game.
+		++NumDropped;
+		return;
+	}
+
+	FOvermindRecord& Entry = Buffer[Head & Mask];
+	Entry.Type = (uint8)Type;
+	Entry.Aux = Aux;
+	Entry.Slot = (int16)Slot;
+	Entry.Frame = Frame;
+	Entry.X = FMath::RoundToInt(Location.X);
+	Entry.Y = FMath::RoundToInt(Location.Y);
+	Entry.Z = FMath::RoundToInt(Location.Z);
+	Entry.Value = Value;
+
+	// Publish the record to the writer thread.
+	WriteIndex.Store(Head + 1);
+}
+
+uint32 FOvermindRecorder::Run()
+{
+	while (!bStopping.Load(EMemoryOrder::Relaxed))
+	{
+		Drain();
+		FPlatformProcess::Sleep(0.01f);
+	}
+	Drain();
+	return 0;
+}
+
+void FOvermindRecorder::Stop()
+{
+	bStopping = true;
+}
+
+void FOvermindRecorder::Drain()
+{
+	const uint64 Tail = ReadIndex.Load(EMemoryOrder::Relaxed);
+	const uint64 Head = WriteIndex.Load();
+	if (Head == Tail || !Writer)
+	{
+		return;
+	}
+
+	// The buffer may wrap, write it in at most two pieces.
+	const uint64 Capacity = Mask + 1;
+	const uint64 Start = Tail & Mask;
+	const uint64 Count = Head - Tail;
+	const uint64 FirstPart = FMath::Min(Count, Capacity - Start);
+	Writer->Serialize(&Buffer[Start], FirstPart * sizeof(FOvermindRecord));
+	if (Count > FirstPart)
+	{
+		Writer->Serialize(&Buffer[0], (Count - FirstPart) * sizeof(FOvermindRecord));
+	}
+
+	// Give the space back to the game thread.
+	ReadIndex.Store(Head);
+}
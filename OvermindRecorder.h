@@ -0,0 +1,193 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Templates/Atomic.h"
+
+// What an Overmind record is about. Comments tell which fields of FOvermindRecord are used.
+enum class EOvermindRecordType : uint8
+{
+	FrameBegin,			// Value: world time in seconds.
+	PhaseTime,			// Aux: EOvermindPhase, Value: microseconds spent on the phase.
+	PlayerCondition,	// Value: difficulty returned by PlayerCondition.
+	Spawn,				// Slot, Location, Aux: SpawnInfo index of the enemy (255 if unknown).
+	PoolMiss,			// Aux: SpawnInfo index the Overmind wanted to spawn.
+	TargetAssigned,		// Slot, Location of the target, Aux: player index.
+	Despawn,			// Slot, Location, Value: distance that made it go past KillEnemyRange.
+	Release,			// Slot, enemy went back to the pool.
+	Recycle,			// Slot, Location: out of range enemy moved straight to a new spawn point, still active.
+	Num
+};
+
+// Parts of the Overmind that get timed.
+enum class EOvermindPhase : uint8
+{
+	Cooldowns,
+	GroupLocation,
+	Vision,
+	DistanceCheck,
+	ActionPicking,
+	Spawn,
+	Crowd,
+	Separation,
+	Activation,
+	MobAI,
+	Pipeline,	// Waiting on and applying the worker pass, with bAsyncPipeline.
+	Num
+};
+
+// One decision, kept small so a busy frame does not cost much to record.
+struct FOvermindRecord
+{
+	uint8 Type;
+	uint8 Aux;
+	int16 Slot;
+	uint32 Frame;
+	// Location rounded to the closest unreal unit.
+	int32 X;
+	int32 Y;
+	int32 Z;
+	float Value;
+};
+static_assert(sizeof(FOvermindRecord) == 24, "FOvermindRecord is written to disk as is, keep it packed.");
+
+// Start of every recording file.
+struct FOvermindRecordHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x524D564F; // "OVMR"
+	// 2 added Recycle.
+	static constexpr uint16 CurrentVersion = 2;
+
+	uint32 Magic;
+	uint16 Version;
+	uint16 RecordSize;
+};
+
+/**
+ * Streams Overmind decisions to a binary file.
+ * The game thread pushes records into a single producer / single consumer ring buffer and never waits,
+ * a background thread drains the buffer to disk. If the disk cannot keep up records are dropped and counted.
+ */
+class NIGHTFALL_API FOvermindRecorder : public FRunnable
+{
+public:
+	/**
+	* @param	InFileName: Where the recording goes.
+	* @param	CapacityPow2: Size of the ring buffer in records, rounded up to a power of two.
+	*/
+	FOvermindRecorder(const FString& InFileName, int32 CapacityPow2 = 1 << 16);
+	virtual ~FOvermindRecorder();
+
+	// Open the file and start the writer thread, false if the file could not be created.
+	bool StartRecording();
+
+	// Flush whatever is left and close the file.
+	void StopRecording();
+
+	// Start a new frame, following records are tagged with it.
+	void BeginFrame(float WorldTime);
+
+	// Push a decision, never blocks.
+	void Record(EOvermindRecordType Type, int32 Slot = -1, const FVector& Location = FVector::ZeroVector, float Value = 0.0f, uint8 Aux = 0);
+
+	const FString& GetFileName() const
+	{
+		return FileName;
+	}
+
+	// Records that did not fit in the buffer.
+	uint32 GetNumDropped() const
+	{
+		return NumDropped;
+	}
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	// Move everything between the read and write positions to the file.
+	void Drain();
+
+	FString FileName;
+	FArchive* Writer;
+	FRunnableThread* Thread;
+
+	TArray<FOvermindRecord> Buffer;
+	uint64 Mask;
+	// Only written by the game thread.
+	TAtomic<uint64> WriteIndex;
+	// Only written by the writer thread.
+	TAtomic<uint64> ReadIndex;
+	TAtomic<bool> bStopping;
+
+	uint32 Frame;
+	uint32 NumDropped;
+};
+
+// Game thread time spent on each phase since the Overmind started, read by tests and tools that sample it.
+struct FOvermindPhaseTimings
+{
+	double TotalMilliseconds[(uint8)EOvermindPhase::Num] = { 0 };
+	// Frames the Overmind ticked.
+	uint64 NumFrames = 0;
+
+	// Seconds from a spawn being asked for (timer or wave) to the enemy being on the map.
+	double TotalSpawnLatency = 0.0;
+	float WorstSpawnLatency = 0.0f;
+	uint64 NumSpawns = 0;
+
+	// Enemies despawned for being too far from the players, and spawns that only replaced one of them shortly after.
+	uint64 NumRangeDespawns = 0;
+	uint64 NumChurnedSpawns = 0;
+	// Out of range enemies moved to a new spawn point instead of going back to the pool.
+	uint64 NumRecycles = 0;
+
+	// Most time spent activating enemies in a single frame.
+	float WorstActivationMilliseconds = 0.0f;
+
+	// Heap allocations the frame arena had to make, stays put once the arena fits a frame. Only the arena's, not every allocation of the Overmind.
+	uint64 NumArenaHeapAllocations = 0;
+
+	void AddSpawnLatency(float Seconds)
+	{
+		TotalSpawnLatency += Seconds;
+		WorstSpawnLatency = FMath::Max(WorstSpawnLatency, Seconds);
+		NumSpawns++;
+	}
+
+	// Worst values can't be subtracted like totals, start them over for a new measure.
+	void ResetWorst()
+	{
+		WorstSpawnLatency = 0.0f;
+		WorstActivationMilliseconds = 0.0f;
+	}
+};
+
+// Time a phase of the Overmind for as long as the scope lives, also sent to the recorder when recording.
+struct FOvermindPhaseScope
+{
+	FOvermindPhaseScope(FOvermindRecorder* InRecorder, EOvermindPhase InPhase, FOvermindPhaseTimings& InTimings) :
+		Recorder(InRecorder), Timings(InTimings), Phase(InPhase), StartCycles(FPlatformTime::Cycles())
+	{
+	}
+
+	~FOvermindPhaseScope()
+	{
+		const float Milliseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles);
+		Timings.TotalMilliseconds[(uint8)Phase] += Milliseconds;
+		if (Recorder)
+		{
+			Recorder->Record(EOvermindRecordType::PhaseTime, -1, FVector::ZeroVector, Milliseconds * 1000.0f, (uint8)Phase);
+		}
+	}
+
+	FOvermindRecorder* Recorder;
+	FOvermindPhaseTimings& Timings;
+	EOvermindPhase Phase;
+	uint32 StartCycles;
+};
@@ -0,0 +1,197 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindReplay.h"
+#include "Misc/FileHelper.h"
+
+bool FOvermindReplay::Load(const FString& FileName)
+{
+	Records.Reset();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FileName))
+	{
+		return false;
+	}
+	if (Bytes.Num() < (int32)sizeof(FOvermindRecordHeader))
+	{
+		return false;
+	}
+
+	FOvermindRecordHeader Header;
+	FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+	if (Header.Magic != FOvermindRecordHeader::ExpectedMagic || Header.Version != FOvermindRecordHeader::CurrentVersion || Header.RecordSize != sizeof(FOvermindRecord))
+	{
+		return false;
+	}
+
+	// A recording cut short (crash, kill -9) may end in the middle of a record, keep what is whole.
+	const int32 NumRecords = (Bytes.Num() - sizeof(Header)) / sizeof(FOvermindRecord);
+	Records.SetNumUninitialized(NumRecords);
+	FMemory::Memcpy(Records.GetData(), Bytes.GetData() + sizeof(Header), NumRecords * sizeof(FOvermindRecord));
+	return true;
+}
+
+FOvermindReplaySummary FOvermindReplay::Run() const
+{
+	FOvermindReplaySummary Summary;
+	Summary.NumRecords = Records.Num();
+
+	// Pool state rebuilt from the decisions.
+	TArray<bool> ActiveSlots;
+	int32 NumActive = 0;
+
+	uint32 CurrentFrame = 0;
+	float FrameMicroseconds = 0.0f;
+	int32 FrameSpawns = 0;
+
+	auto FinishFrame = [&]()
+	{
+		if (FrameMicroseconds > Summary.WorstFrameMicroseconds)
+		{
+			Summary.WorstFrameMicroseconds = FrameMicroseconds;
+			Summary.WorstFrame = CurrentFrame;
+		}
+		if (FrameSpawns > Summary.StormSpawns)
+		{
+			Summary.StormSpawns = FrameSpawns;
+			Summary.StormFrame = CurrentFrame;
+		}
+		FrameMicroseconds = 0.0f;
+		FrameSpawns = 0;
+	};
+
+	for (int32 i = 0; i < Records.Num(); ++i)
+	{
+		const FOvermindRecord& Record = Records[i];
+		if (Record.Type < UE_ARRAY_COUNT(Summary.RecordsByType))
+		{
+			Summary.RecordsByType[Record.Type]++;
+		}
+
+		if (Record.Slot >= ActiveSlots.Num())
+		{
+			ActiveSlots.SetNumZeroed(Record.Slot + 1);
+		}
+
+		switch ((EOvermindRecordType)Record.Type)
+		{
+		case EOvermindRecordType::FrameBegin:
+			FinishFrame();
+			CurrentFrame = Record.Frame;
+			Summary.NumFrames++;
+			break;
+
+		case EOvermindRecordType::PhaseTime:
+			if (Record.Aux < (uint8)EOvermindPhase::Num)
+			{
+				Summary.PhaseTotal[Record.Aux] += Record.Value;
+				Summary.PhaseWorst[Record.Aux] = FMath::Max(Summary.PhaseWorst[Record.Aux], Record.Value);
+			}
+			FrameMicroseconds += Record.Value;
+			break;
+
+		case EOvermindRecordType::Spawn:
+			if (Record.Slot < 0)
+			{
+				break;
+			}
+			if (ActiveSlots[Record.Slot])
+			{
+				Summary.Errors.Add(FString::Printf(TEXT("Record %d: %s, slot is already active"), i, *Describe(Record)));
+				break;
+			}
+			ActiveSlots[Record.Slot] = true;
+			NumActive++;
+			FrameSpawns++;
+			Summary.PeakActive = FMath::Max(Summary.PeakActive, NumActive);
+			break;
+
+		case EOvermindRecordType::TargetAssigned:
+			// Only enemies on the map can see players.
+			if (Record.Slot >= 0 && !ActiveSlots[Record.Slot])
+			{
+				Summary.Errors.Add(FString::Printf(TEXT("Record %d: %s, slot is not active"), i, *Describe(Record)));
+			}
+			break;
+
+		case EOvermindRecordType::Recycle:
+			// Moved, not released, it has to be on the map to begin with.
+			if (Record.Slot >= 0 && !ActiveSlots[Record.Slot])
+			{
+				Summary.Errors.Add(FString::Printf(TEXT("Record %d: %s, slot is not active"), i, *Describe(Record)));
+			}
+			break;
+
+		case EOvermindRecordType::Release:
+			if (Record.Slot < 0)
+			{
+				break;
+			}
+			if (!ActiveSlots[Record.Slot])
+			{
+				Summary.Errors.Add(FString::Printf(TEXT("Record %d: %s, slot is not active"), i, *Describe(Record)));
+				break;
+			}
+			ActiveSlots[Record.Slot] = false;
+			NumActive--;
+			break;
+
+		default:
+			break;
+		}
+	}
+	FinishFrame();
+
+	return Summary;
+}
+
+int32 FOvermindReplay::FindFirstDifference(const FOvermindReplay& Other) const
+{
+	int32 Mine = 0;
+	int32 Theirs = 0;
+	int32 DecisionIndex = 0;
+	while (true)
+	{
+		while (Mine < Records.Num() && !IsDecision(Records[Mine]))
+		{
+			++Mine;
+		}
+		while (Theirs < Other.Records.Num() && !IsDecision(Other.Records[Theirs]))
+		{
+			++Theirs;
+		}
+
+		const bool bMineDone = Mine >= Records.Num();
+		const bool bTheirsDone = Theirs >= Other.Records.Num();
+		if (bMineDone || bTheirsDone)
+		{
+			return bMineDone && bTheirsDone ? -1 : DecisionIndex;
+		}
+
+		const FOvermindRecord& A = Records[Mine];
+		const FOvermindRecord& B = Other.Records[Theirs];
+		if (A.Type != B.Type || A.Aux != B.Aux || A.Slot != B.Slot || A.X != B.X || A.Y != B.Y || A.Z != B.Z || A.Value != B.Value)
+		{
+			return DecisionIndex;
+		}
+
+		++Mine;
+		++Theirs;
+		++DecisionIndex;
+	}
+}
+
+FString FOvermindReplay::Describe(const FOvermindRecord& Record)
+{
+	static const TCHAR* TypeNames[] = { TEXT("FrameBegin"), TEXT("PhaseTime"), TEXT("PlayerCondition"), TEXT("Spawn"), TEXT("PoolMiss"), TEXT("TargetAssigned"), TEXT("Despawn"), TEXT("Release"), TEXT("Recycle") };
+	static_assert(UE_ARRAY_COUNT(TypeNames) == (uint8)EOvermindRecordType::Num, "Add the new record type to TypeNames.");
+	const TCHAR* TypeName = Record.Type < UE_ARRAY_COUNT(TypeNames) ? TypeNames[Record.Type] : TEXT("Unknown");
+	return FString::Printf(TEXT("[frame %u] %s slot=%d aux=%u location=(%d, %d, %d) value=%f"),
+		Record.Frame, TypeName, Record.Slot, Record.Aux, Record.X, Record.Y, Record.Z, Record.Value);
+}
+
+bool FOvermindReplay::IsDecision(const FOvermindRecord& Record)
+{
+	return Record.Type != (uint8)EOvermindRecordType::FrameBegin && Record.Type != (uint8)EOvermindRecordType::PhaseTime;
+}
@@ -0,0 +1,69 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OvermindRecorder.h"
+
+// What came out of replaying a recording.
+struct FOvermindReplaySummary
+{
+	int32 NumFrames = 0;
+	int32 NumRecords = 0;
+	int32 RecordsByType[(uint8)EOvermindRecordType::Num] = { 0 };
+
+	// Total and worst microseconds spent on each phase.
+	double PhaseTotal[(uint8)EOvermindPhase::Num] = { 0 };
+	float PhaseWorst[(uint8)EOvermindPhase::Num] = { 0 };
+
+	// Frame with the highest sum of phase times.
+	uint32 WorstFrame = 0;
+	float WorstFrameMicroseconds = 0.0f;
+
+	// Frame with the most spawns.
+	uint32 StormFrame = 0;
+	int32 StormSpawns = 0;
+
+	// Highest number of enemies active at once.
+	int32 PeakActive = 0;
+
+	// Decisions that do not make sense for the pool, like spawning into a slot that is already in use.
+	TArray<FString> Errors;
+};
+
+/**
+ * Reads a recording made by FOvermindRecorder and summarizes it without a world.
+ * No Overmind decision is made again, only the pool bookkeeping (which slot is active, who can be targeted) is rebuilt
+ * from the recorded ones, so a recording can be profiled and checked for inconsistencies. To check a run is reproduced,
+ * record it twice with the same RandomSeed and compare the two recordings.
+ */
+class NIGHTFALL_API FOvermindReplay
+{
+public:
+	// Load a recording from disk, false if it is missing or not an Overmind recording.
+	bool Load(const FString& FileName);
+
+	// Feed every record through the pool bookkeeping and collect the summary.
+	FOvermindReplaySummary Run() const;
+
+	/**
+	* Compare the decisions of two recordings, ignoring timings.
+	* @return Index of the first decision that differs, or -1 if both made the same decisions.
+	*/
+	int32 FindFirstDifference(const FOvermindReplay& Other) const;
+
+	const TArray<FOvermindRecord>& GetRecords() const
+	{
+		return Records;
+	}
+
+	// Human readable version of one record, for logs.
+	static FString Describe(const FOvermindRecord& Record);
+
+private:
+
+	// Timings and frame markers change from run to run, decisions should not.
+	static bool IsDecision(const FOvermindRecord& Record);
+
+	TArray<FOvermindRecord> Records;
+};
@@ -0,0 +1,93 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindReplayCommandlet.h"
+#include "OvermindBase.h"
+#include "OvermindReplay.h"
+
+UOvermindReplayCommandlet::UOvermindReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UOvermindReplayCommandlet::Main(const FString& Params)
+{
+	// Not -log=, the engine takes that one for its own log file.
+	FString LogFile;
+	if (!FParse::Value(*Params, TEXT("recording="), LogFile))
+	{
+		UE_LOG(LogOvermind, Error, TEXT("OvermindReplay: Missing -recording=<recording>"));
+		return 1;
+	}
+
+	FOvermindReplay Replay;
+	if (!Replay.Load(LogFile))
+	{
+		UE_LOG(LogOvermind, Error, TEXT("OvermindReplay: %s is not an Overmind recording"), *LogFile);
+		return 1;
+	}
+
+	const bool bVerbose = FParse::Param(*Params, TEXT("verbose"));
+	if (bVerbose)
+	{
+		for (const FOvermindRecord& Record : Replay.GetRecords())
+		{
+			UE_LOG(LogOvermind, Display, TEXT("%s"), *FOvermindReplay::Describe(Record));
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FOvermindReplaySummary Summary = Replay.Run();
+	const double ReplayTime = FPlatformTime::Seconds() - StartTime;
+
+	static const TCHAR* PhaseNames[] = { TEXT("Cooldowns"), TEXT("GroupLocation"), TEXT("Vision"), TEXT("DistanceCheck"), TEXT("ActionPicking"), TEXT("Spawn"), TEXT("Crowd"), TEXT("Separation"), TEXT("Activation"), TEXT("MobAI"), TEXT("Pipeline") };
+	static_assert(UE_ARRAY_COUNT(PhaseNames) == (uint8)EOvermindPhase::Num, "Add the new phase to PhaseNames.");
+
+	UE_LOG(LogOvermind, Display, TEXT("OvermindReplay: %s, %d records over %d frames, summarized in %.3f ms"), *LogFile, Summary.NumRecords, Summary.NumFrames, ReplayTime * 1000.0);
+	UE_LOG(LogOvermind, Display, TEXT("  Spawns %d, despawns %d, recycles %d, releases %d, pool misses %d, targets assigned %d, peak active %d"),
+		Summary.RecordsByType[(uint8)EOvermindRecordType::Spawn], Summary.RecordsByType[(uint8)EOvermindRecordType::Despawn],
+		Summary.RecordsByType[(uint8)EOvermindRecordType::Recycle],
+		Summary.RecordsByType[(uint8)EOvermindRecordType::Release], Summary.RecordsByType[(uint8)EOvermindRecordType::PoolMiss],
+		Summary.RecordsByType[(uint8)EOvermindRecordType::TargetAssigned], Summary.PeakActive);
+	for (int32 Phase = 0; Phase < (int32)EOvermindPhase::Num; ++Phase)
+	{
+		UE_LOG(LogOvermind, Display, TEXT("  %-14s average %8.2f us, worst %8.2f us"), PhaseNames[Phase],
+			Summary.NumFrames > 0 ? Summary.PhaseTotal[Phase] / Summary.NumFrames : 0.0, Summary.PhaseWorst[Phase]);
+	}
+	UE_LOG(LogOvermind, Display, TEXT("  Worst frame %u (%.2f us), biggest spawn storm frame %u (%d spawns)"),
+		Summary.WorstFrame, Summary.WorstFrameMicroseconds, Summary.StormFrame, Summary.StormSpawns);
+
+	int32 Result = 0;
+	for (const FString& Error : Summary.Errors)
+	{
+		UE_LOG(LogOvermind, Error, TEXT("  %s"), *Error);
+		Result = 1;
+	}
+
+	FString CompareFile;
+	if (FParse::Value(*Params, TEXT("compare="), CompareFile))
+	{
+		FOvermindReplay Other;
+		if (!Other.Load(CompareFile))
+		{
+			UE_LOG(LogOvermind, Error, TEXT("OvermindReplay: %s is not an Overmind recording"), *CompareFile);
+			return 1;
+		}
+
+		const int32 Difference = Replay.FindFirstDifference(Other);
+		if (Difference == -1)
+		{
+			UE_LOG(LogOvermind, Display, TEXT("OvermindReplay: Same decisions as %s"), *CompareFile);
+		}
+		else
+		{
+			UE_LOG(LogOvermind, Error, TEXT("OvermindReplay: Decision %d differs from %s"), Difference, *CompareFile);
+			Result = 1;
+		}
+	}
+
+	return Result;
+}
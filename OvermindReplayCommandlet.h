@@ -0,0 +1,23 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "OvermindReplayCommandlet.generated.h"
+
+/**
+ * Summarizes an Overmind recording headlessly and prints where the time went, decisions are read back, not made again.
+ * Usage: UE4Editor-Cmd Nightfall -run=OvermindReplay -recording=<recording> [-compare=<recording>] [-verbose]
+ * Returns non zero if the recording is inconsistent or if it does not match the one given to -compare.
+ */
+UCLASS()
+class NIGHTFALL_API UOvermindReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UOvermindReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
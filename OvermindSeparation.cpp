@@ -0,0 +1,105 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindSeparation.h"
+#include "Async/ParallelFor.h"
+
+void FOvermindSeparation::Build(const TArray<FVector>& Positions, float InRadius)
+{
+	Radius = FMath::Max(InRadius, 1.0f);
+	InvCellSize = 1.0f / Radius;
+
+	// Twice as many buckets as agents keeps collisions between cells rare.
+	const int32 NumAgents = Positions.Num();
+	const uint32 TableSize = FMath::RoundUpToPowerOfTwo(FMath::Max(NumAgents * 2, 64));
+	TableMask = TableSize - 1;
+
+	// Counting sort of the agents by bucket.
+	CellStart.Reset();
+	CellStart.AddZeroed(TableSize + 1);
+	AgentBuckets.SetNumUninitialized(NumAgents);
+	for (int32 i = 0; i < NumAgents; ++i)
+	{
+		const uint32 Bucket = HashCell(ToCell(Positions[i].X), ToCell(Positions[i].Y));
+		AgentBuckets[i] = Bucket;
+		CellStart[Bucket + 1]++;
+	}
+	for (uint32 Bucket = 1; Bucket <= TableSize; ++Bucket)
+	{
+		CellStart[Bucket] += CellStart[Bucket - 1];
+	}
+
+	BucketCursor.SetNumUninitialized(TableSize);
+	FMemory::Memcpy(BucketCursor.GetData(), CellStart.GetData(), TableSize * sizeof(int32));
+	SortedAgents.SetNumUninitialized(NumAgents);
+	for (int32 i = 0; i < NumAgents; ++i)
+	{
+		SortedAgents[BucketCursor[AgentBuckets[i]]++] = i;
+	}
+}
+
+void FOvermindSeparation::ComputeOffsets(const TArray<FVector>& Positions, TArray<FVector>& OutOffsets, bool bParallel) const
+{
+	const int32 NumAgents = Positions.Num();
+	OutOffsets.SetNumUninitialized(NumAgents);
+	const float RadiusSquared = Radius * Radius;
+
+	ParallelFor(NumAgents, [&](int32 i)
+	{
+		const FVector& Position = Positions[i];
+		const int32 CellX = ToCell(Position.X);
+		const int32 CellY = ToCell(Position.Y);
+
+		// Two of the nine cells can land on the same bucket, do not count those neighbours twice.
+		uint32 Visited[9];
+		int32 NumVisited = 0;
+
+		FVector Offset = FVector::ZeroVector;
+		for (int32 y = -1; y <= 1; ++y)
+		{
+			for (int32 x = -1; x <= 1; ++x)
+			{
+				const uint32 Bucket = HashCell(CellX + x, CellY + y);
+				bool bSeen = false;
+				for (int32 v = 0; v < NumVisited; ++v)
+				{
+					bSeen |= Visited[v] == Bucket;
+				}
+				if (bSeen)
+				{
+					continue;
+				}
+				Visited[NumVisited++] = Bucket;
+
+				for (int32 k = CellStart[Bucket]; k < CellStart[Bucket + 1]; ++k)
+				{
+					const int32 Other = SortedAgents[k];
+					if (Other == i)
+					{
+						continue;
+					}
+
+					const FVector Away = Position - Positions[Other];
+					const float DistanceSquared = Away.SizeSquared();
+					if (DistanceSquared >= RadiusSquared)
+					{
+						continue;
+					}
+
+					// Right on top of each other, any direction will do as long as the pair goes opposite ways.
+					const float FlatSquared = Away.X * Away.X + Away.Y * Away.Y;
+					if (FlatSquared < KINDA_SMALL_NUMBER)
+					{
+						const float Angle = FMath::Min(i, Other) * 0.618f + (i < Other ? 0.0f : PI);
+						Offset += FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+						continue;
+					}
+
+					const float Distance = FMath::Sqrt(DistanceSquared);
+					Offset += FVector(Away.X, Away.Y, 0.0f) * ((1.0f - Distance / Radius) / FMath::Sqrt(FlatSquared));
+				}
+			}
+		}
+		OutOffsets[i] = Offset.GetClampedToMaxSize(1.0f);
+	}, !bParallel);
+}
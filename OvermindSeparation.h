@@ -0,0 +1,49 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Separation steering for the whole horde in one pass.
+ * Agents are bucketed on a hashed 2D grid whose cells are as big as the separation radius, so every agent only looks
+ * at the 3x3 cells around it and the cost grows with the number of agents instead of the number of pairs.
+ * Each agent only writes its own offset, the pass runs on worker threads when there are enough agents.
+ */
+class NIGHTFALL_API FOvermindSeparation
+{
+public:
+	// Bucket every position on the grid, Radius is how close two agents can get before pushing each other.
+	void Build(const TArray<FVector>& Positions, float InRadius);
+
+	/**
+	* Push every agent away from the neighbours closer than Radius, the closer the harder.
+	* @param	Positions: Same positions given to Build.
+	* @param	OutOffsets: One direction per position, flat on the ground and at most 1 long.
+	* @param	bParallel: Split the agents between worker threads.
+	*/
+	void ComputeOffsets(const TArray<FVector>& Positions, TArray<FVector>& OutOffsets, bool bParallel) const;
+
+private:
+
+	FORCEINLINE uint32 HashCell(int32 X, int32 Y) const
+	{
+		return (((uint32)X * 73856093u) ^ ((uint32)Y * 19349663u)) & TableMask;
+	}
+
+	FORCEINLINE int32 ToCell(float Coordinate) const
+	{
+		return FMath::FloorToInt(Coordinate * InvCellSize);
+	}
+
+	// Agents of bucket N are SortedAgents[CellStart[N]] to SortedAgents[CellStart[N + 1] - 1].
+	TArray<int32> CellStart;
+	TArray<int32> SortedAgents;
+	// Scratch space of Build, kept around so it does not allocate every frame.
+	TArray<uint32> AgentBuckets;
+	TArray<int32> BucketCursor;
+
+	float Radius = 0.0f;
+	float InvCellSize = 0.0f;
+	uint32 TableMask = 0;
+};
@@ -0,0 +1,129 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindSharedData.h"
+#include "OvermindBase.h"
+#include "Misc/ScopeLock.h"
+
+FOvermindVisionGridPtr FOvermindSharedData::FindOrBuildVisionGrid(const FString& MapName, const FBox& Bounds, float VoxelSize, bool bRebuild, TFunctionRef<bool(FOvermindVoxelGrid&)> Build)
+{
+	const FString Key = MakeVisionGridKey(MapName, Bounds, VoxelSize);
+
+	FScopeLock Lock(&GetLock());
+	RemoveExpired();
+
+	if (!bRebuild)
+	{
+		FOvermindVisionGridPtr Existing = GetVisionGrids().FindRef(Key).Pin();
+		if (Existing.IsValid())
+		{
+			UE_LOG(LogOvermind, Log, TEXT("Overmind: Sharing the vision grid of %s"), *MapName);
+			return Existing;
+		}
+	}
+
+	TSharedPtr<FOvermindVoxelGrid, ESPMode::ThreadSafe> Grid = MakeShared<FOvermindVoxelGrid, ESPMode::ThreadSafe>();
+	if (!Build(*Grid) || !Grid->IsBaked())
+	{
+		return nullptr;
+	}
+	GetVisionGrids().Add(Key, Grid);
+	return Grid;
+}
+
+FOvermindVisionGridPtr FOvermindSharedData::ShareVisionGrid(const FString& MapName, const FBox& Bounds, float VoxelSize, const FOvermindVisionGridPtr& Grid, bool bReplace)
+{
+	const FString Key = MakeVisionGridKey(MapName, Bounds, VoxelSize);
+
+	FScopeLock Lock(&GetLock());
+	RemoveExpired();
+
+	if (!bReplace)
+	{
+		// Another session of the map finished first.
+		FOvermindVisionGridPtr Existing = GetVisionGrids().FindRef(Key).Pin();
+		if (Existing.IsValid())
+		{
+			return Existing;
+		}
+	}
+	GetVisionGrids().Add(Key, Grid);
+	return Grid;
+}
+
+FEnemyStateTablePtr FOvermindSharedData::FindOrCompileStateTable(const UEnemyStateMachineAsset& Asset)
+{
+	const FString Key = Asset.GetPathName();
+
+	FScopeLock Lock(&GetLock());
+	RemoveExpired();
+
+	FEnemyStateTablePtr Existing = GetStateTables().FindRef(Key).Pin();
+	if (Existing.IsValid())
+	{
+		return Existing;
+	}
+
+	TSharedPtr<FEnemyStateTable, ESPMode::ThreadSafe> Table = MakeShared<FEnemyStateTable, ESPMode::ThreadSafe>();
+	if (!Table->Compile(Asset))
+	{
+		return nullptr;
+	}
+	GetStateTables().Add(Key, Table);
+	return Table;
+}
+
+int32 FOvermindSharedData::GetNumVisionGrids()
+{
+	FScopeLock Lock(&GetLock());
+	RemoveExpired();
+	return GetVisionGrids().Num();
+}
+
+int32 FOvermindSharedData::GetNumStateTables()
+{
+	FScopeLock Lock(&GetLock());
+	RemoveExpired();
+	return GetStateTables().Num();
+}
+
+FString FOvermindSharedData::MakeVisionGridKey(const FString& MapName, const FBox& Bounds, float VoxelSize)
+{
+	return FString::Printf(TEXT("%s %s %g"), *MapName, *Bounds.ToString(), VoxelSize);
+}
+
+void FOvermindSharedData::RemoveExpired()
+{
+	for (auto It = GetVisionGrids().CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = GetStateTables().CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FCriticalSection& FOvermindSharedData::GetLock()
+{
+	static FCriticalSection Lock;
+	return Lock;
+}
+
+TMap<FString, TWeakPtr<const FOvermindVoxelGrid, ESPMode::ThreadSafe>>& FOvermindSharedData::GetVisionGrids()
+{
+	static TMap<FString, TWeakPtr<const FOvermindVoxelGrid, ESPMode::ThreadSafe>> VisionGrids;
+	return VisionGrids;
+}
+
+TMap<FString, TWeakPtr<const FEnemyStateTable, ESPMode::ThreadSafe>>& FOvermindSharedData::GetStateTables()
+{
+	static TMap<FString, TWeakPtr<const FEnemyStateTable, ESPMode::ThreadSafe>> StateTables;
+	return StateTables;
+}
@@ -0,0 +1,52 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OvermindVoxelGrid.h"
+#include "EnemyStateMachine.h"
+
+typedef TSharedPtr<const FOvermindVoxelGrid, ESPMode::ThreadSafe> FOvermindVisionGridPtr;
+typedef TSharedPtr<const FEnemyStateTable, ESPMode::ThreadSafe> FEnemyStateTablePtr;
+
+/**
+ * Data of an Overmind that never changes once it is built and only depends on the map or on an asset: the vision grid
+ * and compiled mob state machines. Built by the first Overmind that asks for it and shared read only with every other
+ * Overmind of the process, so a server hosting several sessions of a map keeps a single copy and only the first session
+ * pays for loading or baking it. Entries go away with the last Overmind holding them.
+ */
+class NIGHTFALL_API FOvermindSharedData
+{
+public:
+	/**
+	* Vision grid of this map, bounds and voxel size.
+	* @param	bRebuild: Build it again even if there is one. Overminds holding the old grid keep it until they ask again.
+	* @param	Build: Load the grid, false if there is no grid to be had. Called with the lock held, so keep it quick, baking goes through ShareVisionGrid.
+	*/
+	static FOvermindVisionGridPtr FindOrBuildVisionGrid(const FString& MapName, const FBox& Bounds, float VoxelSize, bool bRebuild, TFunctionRef<bool(FOvermindVoxelGrid&)> Build);
+
+	/**
+	* Hand a grid an Overmind finished baking to the other Overminds.
+	* @param	bReplace: Take the place of the grid already shared, if any. Otherwise the one already shared wins and is returned.
+	*/
+	static FOvermindVisionGridPtr ShareVisionGrid(const FString& MapName, const FBox& Bounds, float VoxelSize, const FOvermindVisionGridPtr& Grid, bool bReplace);
+
+	// Compiled version of a state machine asset, null if it has no states.
+	static FEnemyStateTablePtr FindOrCompileStateTable(const UEnemyStateMachineAsset& Asset);
+
+	// Entries still alive, for logs and tests.
+	static int32 GetNumVisionGrids();
+	static int32 GetNumStateTables();
+
+private:
+
+	// Forget entries nobody holds anymore. Lock must be held.
+	static void RemoveExpired();
+
+	// A grid only fits the bounds and voxel size it was built for.
+	static FString MakeVisionGridKey(const FString& MapName, const FBox& Bounds, float VoxelSize);
+
+	static FCriticalSection& GetLock();
+	static TMap<FString, TWeakPtr<const FOvermindVoxelGrid, ESPMode::ThreadSafe>>& GetVisionGrids();
+	static TMap<FString, TWeakPtr<const FEnemyStateTable, ESPMode::ThreadSafe>>& GetStateTables();
+};
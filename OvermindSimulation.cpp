@@ -0,0 +1,381 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindSimulation.h"
+#include "OvermindPipeline.h"
+
+FOvermindSimulationSettings FOvermindSimulationSettings::FromOvermind(const AOvermindBase& Overmind)
+{
+	FOvermindSimulationSettings Result;
+	Result.StartSpawnDelay = Overmind.StartSpawnDelay;
+	Result.CooldownSpawn = Overmind.CooldownSpawn;
+	Result.bSpawnInWaves = Overmind.bSpawnInWaves;
+	Result.WaveSizePerCondition = Overmind.WaveSizePerCondition;
+	Result.InnerSpawnRadius = Overmind.InnerSpawnRadius;
+	Result.OuterSpawnRadius = Overmind.OuterSpawnRadius;
+	Result.KillEnemyRange = Overmind.KillEnemyRange;
+	Result.MinSpawnSeparation = Overmind.MinSpawnSeparation;
+	Result.MaxSpawnAttempts = Overmind.MaxSpawnAttempts;
+	Result.PlayerClusterRadius = Overmind.PlayerClusterRadius;
+	Result.bRecycleOutOfRangeEnemies = Overmind.bRecycleOutOfRangeEnemies;
+	Result.ChurnWindow = Overmind.ChurnWindow;
+	Result.SpawnInfo = Overmind.SpawnInfo;
+	return Result;
+}
+
+FOvermindSimulation::FOvermindSimulation(const FOvermindSimulationSettings& InSettings) :
+	Settings(InSettings), Random(InSettings.Seed, 0), AverageGroupLocation(FVector::ZeroVector), Time(0.0f), TimeToNextSpawn(0.0f), NumActive(0), ActiveSeconds(0.0)
+{
+	// Pool like StartEnemyPool builds it, one slot per enemy of every type.
+	for (int32 Type = 0; Type < Settings.SpawnInfo.Num(); ++Type)
+	{
+		for (int32 i = 0; i < Settings.SpawnInfo[Type].Quantity; ++i)
+		{
+			Enemies.Add({ Type, false, FVector::ZeroVector });
+		}
+	}
+	Result.PoolSize = Enemies.Num();
+
+	for (int32 i = 0; i < Settings.NumPlayers; ++i)
+	{
+		FSimPlayer Player;
+		Player.Location = FVector(Random.RandRange(-200.0f, 200.0f), Random.RandRange(-200.0f, 200.0f), 0.0f);
+		Player.Waypoint = Player.Location;
+		Player.Health = Settings.PlayerMaxHealth;
+		Player.TimeToKill = Settings.PlayerKillInterval;
+		Players.Add(Player);
+	}
+	PlayerLocations.SetNumZeroed(Players.Num());
+	PlayerClusterIndex.Init(INDEX_NONE, Players.Num());
+	TimeToNextSpawn = Settings.StartSpawnDelay;
+}
+
+FOvermindSimulationResult FOvermindSimulation::Run()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const float DeltaTime = FMath::Max(Settings.TimeStep, 0.001f);
+	while (Time < Settings.Duration)
+	{
+		Step(DeltaTime);
+		Time += DeltaTime;
+	}
+
+	Result.SimulatedSeconds = Time;
+	Result.PoolUtilization = Result.PoolSize > 0 && Time > 0.0f ? (float)(ActiveSeconds / (Time * Result.PoolSize)) : 0.0f;
+	Result.CpuSeconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+void FOvermindSimulation::Step(float DeltaTime)
+{
+	MovePlayers(DeltaTime);
+
+	// Group location and clusters, every frame, there is no cell grid to skip frames with.
+	AverageGroupLocation = FVector::ZeroVector;
+	for (int32 i = 0; i < Players.Num(); ++i)
+	{
+		PlayerLocations[i] = Players[i].Location;
+		AverageGroupLocation += Players[i].Location;
+	}
+	if (Players.Num() > 0)
+	{
+		AverageGroupLocation /= Players.Num();
+	}
+	FOvermindPipeline::UpdatePlayerClusters(PlayerLocations, [](int32 Player) { return true; }, Settings.PlayerClusterRadius, PlayerClusters, PlayerClusterIndex);
+
+	// Spawn timer.
+	TimeToNextSpawn -= DeltaTime;
+	while (TimeToNextSpawn <= 0.0f)
+	{
+		MakeEnemy();
+		TimeToNextSpawn += FMath::Max(Settings.CooldownSpawn, DeltaTime);
+	}
+
+	CheckRange();
+	MoveEnemies(DeltaTime);
+
+	ActiveSeconds += NumActive * DeltaTime;
+	Result.PeakActive = FMath::Max(Result.PeakActive, NumActive);
+}
+
+void FOvermindSimulation::MovePlayers(float DeltaTime)
+{
+	for (FSimPlayer& Player : Players)
+	{
+		FVector ToWaypoint = Player.Waypoint - Player.Location;
+		const float Distance = ToWaypoint.Size();
+		const float Move = Settings.PlayerSpeed * DeltaTime;
+		if (Distance <= Move)
+		{
+			Player.Location = Player.Waypoint;
+			const float Angle = Random.RandRange(0.0f, 2.0f * PI);
+			const float Radius = Settings.ArenaRadius * FMath::Sqrt(Random.NextFloat());
+			Player.Waypoint = FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.0f);
+		}
+		else
+		{
+			Player.Location += ToWaypoint / Distance * Move;
+		}
+
+		Player.Health = FMath::Min(Player.Health + Settings.PlayerRegenPerSecond * DeltaTime, Settings.PlayerMaxHealth);
+		Player.TimeToKill = FMath::Max(Player.TimeToKill - DeltaTime, 0.0f);
+	}
+}
+
+void FOvermindSimulation::MoveEnemies(float DeltaTime)
+{
+	const float SightSquared = Settings.EnemySightRadius * Settings.EnemySightRadius;
+	const float AttackSquared = Settings.AttackRange * Settings.AttackRange;
+	for (int32 e = 0; e < Enemies.Num(); ++e)
+	{
+		FSimEnemy& Enemy = Enemies[e];
+		if (!Enemy.bActive)
+		{
+			continue;
+		}
+
+		int32 Closest = INDEX_NONE;
+		float ClosestSquared = SightSquared;
+		for (int32 p = 0; p < Players.Num(); ++p)
+		{
+			const float DistanceSquared = FVector::DistSquared(Enemy.Location, Players[p].Location);
+			if (DistanceSquared <= ClosestSquared)
+			{
+				ClosestSquared = DistanceSquared;
+				Closest = p;
+			}
+		}
+		if (Closest == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FSimPlayer& Player = Players[Closest];
+		if (ClosestSquared > AttackSquared)
+		{
+			const FVector ToPlayer = Player.Location - Enemy.Location;
+			Enemy.Location += ToPlayer.GetSafeNormal() * FMath::Min(Settings.EnemySpeed * DeltaTime, FMath::Sqrt(ClosestSquared));
+			continue;
+		}
+
+		// In a fight, the enemy hurts the player and the player kills what is next to it.
+		Player.Health -= Settings.EnemyDamagePerSecond * DeltaTime;
+		if (Player.Health <= 0.0f)
+		{
+			Result.NumPlayerDeaths++;
+			Player.Health = Settings.PlayerMaxHealth;
+		}
+		if (Player.TimeToKill <= 0.0f)
+		{
+			Player.TimeToKill = Settings.PlayerKillInterval;
+			Enemy.bActive = false;
+			NumActive--;
+			Result.NumKills++;
+		}
+	}
+}
+
+void FOvermindSimulation::CheckRange()
+{
+	const float KillRangeSquared = Settings.KillEnemyRange * Settings.KillEnemyRange;
+	for (int32 i = 0; i < Enemies.Num(); ++i)
+	{
+		FSimEnemy& Enemy = Enemies[i];
+		if (!Enemy.bActive)
+		{
+			continue;
+		}
+
+		float ClosestSquared = PlayerClusters.Num() > 0 ? MAX_flt : FVector::DistSquared(Enemy.Location, AverageGroupLocation);
+		for (const FOvermindPlayerCluster& Cluster : PlayerClusters)
+		{
+			ClosestSquared = FMath::Min(ClosestSquared, FVector::DistSquared(Enemy.Location, Cluster.Center));
+		}
+		if (ClosestSquared <= KillRangeSquared)
+		{
+			continue;
+		}
+
+		// Same as AOvermindBase::RecycleEnemy: draw a type like a spawn would, a pooled enemy of that type goes
+		// instead when this one is of another type.
+		if (Settings.bRecycleOutOfRangeEnemies)
+		{
+			const int32 TypeIndex = AOvermindBase::PickEnemyType(Settings.SpawnInfo, Random.RandRange(0.0f, 100.0f));
+			int32 SpawnSlot = INDEX_NONE;
+			if (TypeIndex == Enemy.TypeIndex)
+			{
+				SpawnSlot = i;
+			}
+			else if (TypeIndex != -1)
+			{
+				SpawnSlot = Enemies.IndexOfByPredicate([TypeIndex](const FSimEnemy& Other) { return !Other.bActive && Other.TypeIndex == TypeIndex; });
+			}
+
+			FVector Location;
+			bool bFound = false;
+			ReservedLocations.Reset();
+			for (int32 Attempt = 0; SpawnSlot != INDEX_NONE && Attempt < Settings.MaxSpawnAttempts && !bFound; ++Attempt)
+			{
+				bFound = FindSpawnLocation(Location);
+			}
+			if (bFound && SpawnSlot == i)
+			{
+				Enemy.Location = Location;
+				Result.NumRecycles++;
+				continue;
+			}
+			if (bFound)
+			{
+				// Despawned and spawned in the same go, nothing on the map goes missing.
+				Enemy.bActive = false;
+				Enemies[SpawnSlot].bActive = true;
+				Enemies[SpawnSlot].Location = Location;
+				Result.NumSpawns++;
+				continue;
+			}
+		}
+
+		Enemy.bActive = false;
+		NumActive--;
+		Result.NumRangeDespawns++;
+		RecentRangeDespawns.Add(Time);
+	}
+}
+
+void FOvermindSimulation::MakeEnemy()
+{
+	const int32 Count = Settings.bSpawnInWaves ? FMath::Max(1, FMath::RoundToInt(PlayerCondition() * Settings.WaveSizePerCondition)) : 1;
+	ReservedLocations.Reset();
+	for (int32 n = 0; n < Count; ++n)
+	{
+		const int32 Slot = FirstAvailableEnemy();
+		if (Slot == INDEX_NONE)
+		{
+			break;
+		}
+
+		FVector Location;
+		bool bFound = false;
+		for (int32 Attempt = 0; Attempt < Settings.MaxSpawnAttempts && !bFound; ++Attempt)
+		{
+			bFound = FindSpawnLocation(Location);
+		}
+		if (!bFound)
+		{
+			continue;
+		}
+
+		ReservedLocations.Add(Location);
+		Enemies[Slot].bActive = true;
+		Enemies[Slot].Location = Location;
+		NumActive++;
+		Result.NumSpawns++;
+		CountSpawnChurn();
+	}
+}
+
+int32 FOvermindSimulation::FirstAvailableEnemy()
+{
+	const int32 TypeIndex = AOvermindBase::PickEnemyType(Settings.SpawnInfo, Random.RandRange(0.0f, 100.0f));
+	if (TypeIndex == -1)
+	{
+		return INDEX_NONE;
+	}
+	for (int32 i = 0; i < Enemies.Num(); ++i)
+	{
+		if (!Enemies[i].bActive && Enemies[i].TypeIndex == TypeIndex)
+		{
+			return i;
+		}
+	}
+	Result.NumPoolMisses++;
+	return INDEX_NONE;
+}
+
+bool FOvermindSimulation::FindSpawnLocation(FVector& OutLocation)
+{
+	if (Players.Num() == 0)
+	{
+		return false;
+	}
+	const FSimPlayer& Player = Players[GetFardestPlayer()];
+	Result.NumNavQueries++;
+
+	const float Distance = Settings.OuterSpawnRadius * FMath::Sqrt(Random.NextFloat());
+	const float Angle = Random.RandRange(0.0f, 2.0f * PI);
+	const FVector Candidate = Player.Location + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.0f);
+	if (Distance < Settings.InnerSpawnRadius)
+	{
+		Result.NumRejectedPoints++;
+		return false;
+	}
+
+	// Same visibility test as ValidateSpawnLocation, with a coin flip standing in for the trace. Players walk toward their waypoint.
+	Result.NumTraces += 2;
+	const FVector Forward = (Player.Waypoint - Player.Location).GetSafeNormal();
+	if (FVector::DotProduct(Forward, Candidate - Player.Location) < 0.0f && Random.NextFloat() >= Settings.OccluderChance)
+	{
+		Result.NumRejectedPoints++;
+		return false;
+	}
+
+	const float MinSeparationSquared = Settings.MinSpawnSeparation * Settings.MinSpawnSeparation;
+	for (const FVector& Reserved : ReservedLocations)
+	{
+		if (FVector::DistSquared(Candidate, Reserved) < MinSeparationSquared)
+		{
+			Result.NumRejectedPoints++;
+			return false;
+		}
+	}
+
+	OutLocation = Candidate;
+	return true;
+}
+
+int32 FOvermindSimulation::PlayerCondition() const
+{
+	int32 Condition = 0;
+	for (const FSimPlayer& Player : Players)
+	{
+		Condition += AOvermindBase::ConditionOfHealth(Player.Health / Settings.PlayerMaxHealth);
+	}
+	return Condition;
+}
+
+int32 FOvermindSimulation::GetFardestPlayer() const
+{
+	// Most alone, then farthest from the group, like the Overmind.
+	int32 Index = 0;
+	int32 FewestPlayers = MAX_int32;
+	float FardestDistance = 0.0f;
+	for (int32 i = 0; i < Players.Num(); ++i)
+	{
+		const int32 ClusterPlayers = PlayerClusters.IsValidIndex(PlayerClusterIndex[i]) ? PlayerClusters[PlayerClusterIndex[i]].NumPlayers : 1;
+		const float Distance = FVector::Dist(Players[i].Location, AverageGroupLocation);
+		if (ClusterPlayers < FewestPlayers || (ClusterPlayers == FewestPlayers && Distance > FardestDistance))
+		{
+			FewestPlayers = ClusterPlayers;
+			FardestDistance = Distance;
+			Index = i;
+		}
+	}
+	return Index;
+}
+
+void FOvermindSimulation::CountSpawnChurn()
+{
+	int32 NumExpired = 0;
+	while (NumExpired < RecentRangeDespawns.Num() && Time - RecentRangeDespawns[NumExpired] > Settings.ChurnWindow)
+	{
+		++NumExpired;
+	}
+	RecentRangeDespawns.RemoveAt(0, NumExpired, false);
+
+	// One despawn is matched with one spawn.
+	if (RecentRangeDespawns.Num() > 0)
+	{
+		RecentRangeDespawns.RemoveAt(0, 1, false);
+		Result.NumChurnedSpawns++;
+	}
+}
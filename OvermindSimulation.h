@@ -0,0 +1,146 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OvermindBase.h"
+
+// Everything a simulated run depends on: the Overmind settings being tuned and the scripted fight they are tried on.
+struct FOvermindSimulationSettings
+{
+	// =============== Overmind ===============
+
+	float StartSpawnDelay = 2.0f;
+	float CooldownSpawn = 1.0f;
+	bool bSpawnInWaves = false;
+	float WaveSizePerCondition = 1.0f;
+	float InnerSpawnRadius = 1500.0f;
+	float OuterSpawnRadius = 3000.0f;
+	float KillEnemyRange = 5000.0f;
+	float MinSpawnSeparation = 200.0f;
+	int32 MaxSpawnAttempts = 3;
+	float PlayerClusterRadius = 4000.0f;
+	bool bRecycleOutOfRangeEnemies = false;
+	float ChurnWindow = 5.0f;
+	// Weights and pool sizes, enemy classes are not looked at.
+	TArray<FEnemySpawnInfo> SpawnInfo;
+
+	// =============== Scripted fight ===============
+
+	int32 NumPlayers = 4;
+	// Players walk from one random point to the next inside this radius of the origin.
+	float ArenaRadius = 6000.0f;
+	float PlayerSpeed = 450.0f;
+	float PlayerMaxHealth = 100.0f;
+	float PlayerRegenPerSecond = 2.0f;
+	// A player kills the closest enemy in AttackRange once every this many seconds.
+	float PlayerKillInterval = 1.5f;
+	float EnemySpeed = 350.0f;
+	float EnemySightRadius = 2500.0f;
+	float AttackRange = 200.0f;
+	float EnemyDamagePerSecond = 2.0f;
+	// Chance that something stands between a player and a spawn point, there is no level to trace against.
+	float OccluderChance = 0.5f;
+
+	// =============== Run ===============
+
+	float Duration = 600.0f;
+	// Simulated seconds per Overmind frame.
+	float TimeStep = 1.0f / 30.0f;
+	uint64 Seed = 1;
+
+	// Overmind settings taken from an Overmind, its class default object for instance.
+	static FOvermindSimulationSettings FromOvermind(const AOvermindBase& Overmind);
+};
+
+// What came out of a simulated run. Per minute numbers are per simulated minute.
+struct FOvermindSimulationResult
+{
+	int32 PoolSize = 0;
+	int32 NumSpawns = 0;
+	int32 NumRangeDespawns = 0;
+	int32 NumChurnedSpawns = 0;
+	int32 NumRecycles = 0;
+	int32 NumKills = 0;
+	int32 NumPlayerDeaths = 0;
+	int32 NumPoolMisses = 0;
+	// Spawn points thrown away, for any reason, and what the Overmind would have asked of the navmesh and physics for them.
+	int32 NumRejectedPoints = 0;
+	int32 NumNavQueries = 0;
+	int32 NumTraces = 0;
+	// Time averaged share of the pool on the map, and the most enemies on it at once.
+	float PoolUtilization = 0.0f;
+	int32 PeakActive = 0;
+	float SimulatedSeconds = 0.0f;
+	// Wall clock time the run took.
+	double CpuSeconds = 0.0;
+
+	float PerMinute(int32 Count) const
+	{
+		return SimulatedSeconds > 0.0f ? Count * 60.0f / SimulatedSeconds : 0.0f;
+	}
+};
+
+/**
+ * The spawn and despawn rules of AOvermindBase run on a flat, empty map with scripted players, no world, actors or navmesh.
+ * Cheap enough to run a long fight in a fraction of a second, and independent runs can go on as many threads as there are,
+ * which is what tuning CooldownSpawn, spawn radii, KillEnemyRange and weights needs. Enemy behaviour is a stand in
+ * (walk to the closest player in sight and hit it), the numbers are for comparing settings, not for predicting a real match.
+ */
+class NIGHTFALL_API FOvermindSimulation
+{
+public:
+	explicit FOvermindSimulation(const FOvermindSimulationSettings& InSettings);
+
+	// Play the whole fight.
+	FOvermindSimulationResult Run();
+
+private:
+
+	struct FSimPlayer
+	{
+		FVector Location;
+		FVector Waypoint;
+		float Health;
+		float TimeToKill;
+	};
+
+	struct FSimEnemy
+	{
+		int32 TypeIndex;
+		bool bActive;
+		FVector Location;
+	};
+
+	void Step(float DeltaTime);
+	void MovePlayers(float DeltaTime);
+	void MoveEnemies(float DeltaTime);
+	void CheckRange();
+	void MakeEnemy();
+
+	// Same rules as AOvermindBase::FirstAvailableEnemy and FindSpawnLocation.
+	int32 FirstAvailableEnemy();
+	bool FindSpawnLocation(FVector& OutLocation);
+	int32 PlayerCondition() const;
+	int32 GetFardestPlayer() const;
+	void CountSpawnChurn();
+
+	FOvermindSimulationSettings Settings;
+	FOvermindSimulationResult Result;
+	FOvermindRandom Random;
+
+	TArray<FSimPlayer> Players;
+	TArray<FSimEnemy> Enemies;
+	TArray<FVector> PlayerLocations;
+	TArray<FOvermindPlayerCluster> PlayerClusters;
+	TArray<int32> PlayerClusterIndex;
+	FVector AverageGroupLocation;
+	TArray<float> RecentRangeDespawns;
+	// Spawn points taken this wave.
+	TArray<FVector> ReservedLocations;
+
+	float Time;
+	float TimeToNextSpawn;
+	int32 NumActive;
+	double ActiveSeconds;
+};
@@ -0,0 +1,58 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindSnapshot.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+FArchive& operator<<(FArchive& Ar, FOvermindSnapshotSlot& Slot)
+{
+	Ar << Slot.TypeIndex << Slot.bActive;
+	// Pooled enemies all sit at the origin, only the ones on the map need a place.
+	if (Slot.bActive)
+	{
+		Ar << Slot.Location << Slot.Yaw << Slot.Health;
+	}
+	if (Slot.TypeIndex == MAX_uint8)
+	{
+		Ar << Slot.ClassPath;
+	}
+	return Ar;
+}
+
+void FOvermindSnapshot::Save(TArray<uint8>& OutData)
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint32 Magic = ExpectedMagic;
+	uint16 Version = CurrentVersion;
+	Writer << Magic << Version;
+	Serialize(Writer);
+}
+
+bool FOvermindSnapshot::Load(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != ExpectedMagic || Version != CurrentVersion)
+	{
+		return false;
+	}
+
+	FOvermindSnapshot Loaded;
+	Loaded.Serialize(Reader);
+	if (Reader.IsError())
+	{
+		return false;
+	}
+	*this = MoveTemp(Loaded);
+	return true;
+}
+
+void FOvermindSnapshot::Serialize(FArchive& Ar)
+{
+	Ar << Random << NavQueryRandom << TimeToNextSpawn << Slots << ProxyLocations;
+}
@@ -0,0 +1,49 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OvermindRandom.h"
+
+// One slot of the enemy pool.
+struct FOvermindSnapshotSlot
+{
+	// SpawnInfo index of the enemy, MAX_uint8 for enemies placed by hand that are not on SpawnInfo.
+	uint8 TypeIndex = MAX_uint8;
+	bool bActive = false;
+	FVector Location = FVector::ZeroVector;
+	float Yaw = 0.0f;
+	float Health = 0.0f;
+	// Only for TypeIndex MAX_uint8, to make sure the same enemy is in the slot.
+	FString ClassPath;
+
+	friend FArchive& operator<<(FArchive& Ar, FOvermindSnapshotSlot& Slot);
+};
+
+/**
+ * Pool and spawn state of an Overmind, small enough to keep in memory for quick restarts and to store in a save game.
+ * Restoring it resets the pooled enemies in place, nothing is destroyed and only missing pool slots are spawned.
+ */
+struct NIGHTFALL_API FOvermindSnapshot
+{
+	static constexpr uint32 ExpectedMagic = 0x534D564F; // "OVMS"
+	static constexpr uint16 CurrentVersion = 2;
+
+	FOvermindRandom Random;
+	// Stream the spawn point queries draw from.
+	FOvermindRandom NavQueryRandom;
+	// Seconds until the spawn timer fires, negative if it was not running.
+	float TimeToNextSpawn = -1.0f;
+	TArray<FOvermindSnapshotSlot> Slots;
+	// Proxy locations, one list per SpawnInfo type.
+	TArray<TArray<FVector>> ProxyLocations;
+
+	void Save(TArray<uint8>& OutData);
+
+	// False if Data is not a snapshot or was made by another version, this snapshot is left alone then.
+	bool Load(const TArray<uint8>& Data);
+
+private:
+
+	void Serialize(FArchive& Ar);
+};
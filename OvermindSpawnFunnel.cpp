@@ -0,0 +1,127 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindSpawnFunnel.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawns requested"), STAT_OvermindSpawnRequested, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn attempts"), STAT_OvermindSpawnAttempts, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn rejections"), STAT_OvermindSpawnRejected, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn navmesh queries"), STAT_OvermindSpawnNavQueries, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn traces"), STAT_OvermindSpawnTraces, STATGROUP_Overmind);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies spawned"), STAT_OvermindSpawned, STATGROUP_Overmind);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies spawned (total)"), STAT_OvermindSpawnedTotal, STATGROUP_Overmind);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Worst spawn latency (s)"), STAT_OvermindWorstSpawnLatency, STATGROUP_Overmind);
+
+const float FOvermindSpawnFunnel::LatencyBucketLimits[NumLatencyBuckets - 1] = { 0.0f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f, 2.0f };
+
+void FOvermindSpawnFunnel::AddRequests(int32 Count)
+{
+	NumRequested += Count;
+	INC_DWORD_STAT_BY(STAT_OvermindSpawnRequested, Count);
+}
+
+void FOvermindSpawnFunnel::AddAttempt()
+{
+	NumAttempts++;
+	INC_DWORD_STAT(STAT_OvermindSpawnAttempts);
+}
+
+void FOvermindSpawnFunnel::AddNavQuery()
+{
+	NumNavQueries++;
+	INC_DWORD_STAT(STAT_OvermindSpawnNavQueries);
+}
+
+void FOvermindSpawnFunnel::AddTrace()
+{
+	NumTraces++;
+	INC_DWORD_STAT(STAT_OvermindSpawnTraces);
+}
+
+void FOvermindSpawnFunnel::Reject(EOvermindSpawnReject Reason)
+{
+	NumRejected[(uint8)Reason]++;
+	INC_DWORD_STAT(STAT_OvermindSpawnRejected);
+}
+
+void FOvermindSpawnFunnel::AddSpawn(float LatencySeconds)
+{
+	NumSpawned++;
+	int32 Bucket = 0;
+	while (Bucket < NumLatencyBuckets - 1 && LatencySeconds > LatencyBucketLimits[Bucket])
+	{
+		++Bucket;
+	}
+	LatencyBuckets[Bucket]++;
+	WorstLatency = FMath::Max(WorstLatency, LatencySeconds);
+
+	INC_DWORD_STAT(STAT_OvermindSpawned);
+	INC_DWORD_STAT(STAT_OvermindSpawnedTotal);
+	SET_FLOAT_STAT(STAT_OvermindWorstSpawnLatency, WorstLatency);
+}
+
+FOvermindSpawnFunnel FOvermindSpawnFunnel::Delta(const FOvermindSpawnFunnel& Earlier) const
+{
+	FOvermindSpawnFunnel Result = *this;
+	Result.NumRequested -= Earlier.NumRequested;
+	Result.NumAttempts -= Earlier.NumAttempts;
+	for (int32 i = 0; i < (int32)EOvermindSpawnReject::Num; ++i)
+	{
+		Result.NumRejected[i] -= Earlier.NumRejected[i];
+	}
+	Result.NumNavQueries -= Earlier.NumNavQueries;
+	Result.NumTraces -= Earlier.NumTraces;
+	Result.NumSpawned -= Earlier.NumSpawned;
+	for (int32 i = 0; i < NumLatencyBuckets; ++i)
+	{
+		Result.LatencyBuckets[i] -= Earlier.LatencyBuckets[i];
+	}
+	return Result;
+}
+
+float FOvermindSpawnFunnel::LatencyPercentile(float Fraction) const
+{
+	uint64 Total = 0;
+	for (int32 i = 0; i < NumLatencyBuckets; ++i)
+	{
+		Total += LatencyBuckets[i];
+	}
+
+	uint64 Seen = 0;
+	for (int32 i = 0; i < NumLatencyBuckets - 1; ++i)
+	{
+		Seen += LatencyBuckets[i];
+		if (Total > 0 && Seen >= Fraction * Total)
+		{
+			return LatencyBucketLimits[i];
+		}
+	}
+	return Total > 0 ? MAX_flt : 0.0f;
+}
+
+FString FOvermindSpawnFunnel::Describe() const
+{
+	FString Line = FString::Printf(TEXT("%llu requested, %llu spawned, %llu attempts, rejected:"), NumRequested, NumSpawned, NumAttempts);
+	for (int32 i = 0; i < (int32)EOvermindSpawnReject::Num; ++i)
+	{
+		Line += FString::Printf(TEXT(" %s %llu"), GetRejectName((EOvermindSpawnReject)i), NumRejected[i]);
+	}
+
+	// Work wasted on each enemy that made it, what the radii and cooldowns get tuned against.
+	const double Spawned = FMath::Max<uint64>(NumSpawned, 1);
+	Line += FString::Printf(TEXT(", per spawn: %.1f attempts %.1f navmesh queries %.1f traces"), NumAttempts / Spawned, NumNavQueries / Spawned, NumTraces / Spawned);
+
+	auto BucketName = [](float Limit)
+	{
+		return Limit == MAX_flt ? FString(TEXT("slower")) : FString::Printf(TEXT("<=%.2fs"), Limit);
+	};
+	Line += FString::Printf(TEXT(", latency p50 %s p90 %s worst %.2fs"), *BucketName(LatencyPercentile(0.5f)), *BucketName(LatencyPercentile(0.9f)), WorstLatency);
+	return Line;
+}
+
+const TCHAR* FOvermindSpawnFunnel::GetRejectName(EOvermindSpawnReject Reason)
+{
+	static const TCHAR* Names[] = { TEXT("NoPlayers"), TEXT("NoPoolSlot"), TEXT("NotReachable"), TEXT("InsideInnerRadius"), TEXT("Visible"), TEXT("NoFloor"), TEXT("TooClose"), TEXT("Unused") };
+	static_assert(UE_ARRAY_COUNT(Names) == (int32)EOvermindSpawnReject::Num, "Name every reject reason.");
+	return (uint8)Reason < (uint8)EOvermindSpawnReject::Num ? Names[(uint8)Reason] : TEXT("Unknown");
+}
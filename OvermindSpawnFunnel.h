@@ -0,0 +1,66 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Overmind"), STATGROUP_Overmind, STATCAT_Advanced);
+
+// Why a spawn point, or a whole spawn, was given up on.
+enum class EOvermindSpawnReject : uint8
+{
+	NoPlayers,			// No world, navmesh or players to spawn around.
+	NoPoolSlot,			// Every enemy of the pool is in use.
+	NotReachable,		// Candidate off the navmesh or not reachable from the player.
+	InsideInnerRadius,	// Too close to the player.
+	Visible,			// In front of the player with nothing in between.
+	NoFloor,			// Floor trace under the point hit nothing.
+	TooClose,			// On top of another enemy being spawned.
+	Unused,				// Navmesh answered after the spawn already had its enemies, wasted query.
+	Num
+};
+
+/**
+ * Counts what the spawn pipeline does, from the timer firing to the enemy being on the map.
+ * Every counter only goes up, take the Delta of two copies to look at a period of time.
+ */
+struct NIGHTFALL_API FOvermindSpawnFunnel
+{
+	// Upper bounds in seconds of the latency buckets, the last bucket takes everything slower.
+	static constexpr int32 NumLatencyBuckets = 8;
+	static const float LatencyBucketLimits[NumLatencyBuckets - 1];
+
+	// Enemies asked for by the timer or waves.
+	uint64 NumRequested = 0;
+	// Spawn points looked at.
+	uint64 NumAttempts = 0;
+	uint64 NumRejected[(uint8)EOvermindSpawnReject::Num] = { 0 };
+	// Reachable point lookups on the navmesh and line traces done for spawning.
+	uint64 NumNavQueries = 0;
+	uint64 NumTraces = 0;
+	// Enemies put on the map, recycled enemies included.
+	uint64 NumSpawned = 0;
+
+	// Seconds from the request to the enemy being active.
+	uint32 LatencyBuckets[NumLatencyBuckets] = { 0 };
+	float WorstLatency = 0.0f;
+
+	void AddRequests(int32 Count);
+	void AddAttempt();
+	void AddNavQuery();
+	void AddTrace();
+	void Reject(EOvermindSpawnReject Reason);
+	void AddSpawn(float LatencySeconds);
+
+	// What happened since Earlier was copied. WorstLatency stays the worst of all time.
+	FOvermindSpawnFunnel Delta(const FOvermindSpawnFunnel& Earlier) const;
+
+	// Smallest bucket limit below which at least Fraction of the spawns landed, MAX_flt if it is the last bucket.
+	float LatencyPercentile(float Fraction) const;
+
+	// One line for the log.
+	FString Describe() const;
+
+	static const TCHAR* GetRejectName(EOvermindSpawnReject Reason);
+};
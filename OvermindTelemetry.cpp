@@ -0,0 +1,292 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindTelemetry.h"
+#include "OvermindBase.h"
+#include "HAL/PlatformProcess.h"
+
+FOvermindTelemetry::FOvermindTelemetry(const FString& InName, uint32 InCapacity) :
+	Name(InName), Region(nullptr), Header(nullptr), Ring(nullptr), WritePosition(0), Frame(0)
+{
+	// Power of two, ring positions are counters masked with Capacity - 1.
+	Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 64 * 1024));
+}
+
+FOvermindTelemetry::~FOvermindTelemetry()
+{
+	Close();
+}
+
+bool FOvermindTelemetry::Open()
+{
+	Close();
+
+	// Two writers on one name would scribble over each other, refuse if a live process already publishes here.
+	// A region left behind by a crash still has its magic set, so check the owner is actually running.
+	if (FPlatformMemory::FSharedMemoryRegion* Existing = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false, (uint32)FPlatformMemory::ESharedMemoryAccess::Read, sizeof(FOvermindTelemetryHeader)))
+	{
+		const FOvermindTelemetryHeader* ExistingHeader = (const FOvermindTelemetryHeader*)Existing->GetAddress();
+		const uint32 OwnerId = ExistingHeader->ProcessId;
+		const bool bInUse = ExistingHeader->Magic == FOvermindTelemetryHeader::ExpectedMagic && FPlatformProcess::IsApplicationRunning(OwnerId);
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Existing);
+		if (bInUse)
+		{
+			UE_LOG(LogOvermind, Warning, TEXT("Overmind: Telemetry region %s is already in use by process %u"), *Name, OwnerId);
+			return false;
+		}
+	}
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, true, (uint32)FPlatformMemory::ESharedMemoryAccess::Read | (uint32)FPlatformMemory::ESharedMemoryAccess::Write, sizeof(FOvermindTelemetryHeader) + Capacity);
+	if (!Region)
+	{
+		UE_LOG(LogOvermind, Warning, TEXT("Overmind: Could not create telemetry region %s"), *Name);
+		return false;
+	}
+
+	Header = (FOvermindTelemetryHeader*)Region->GetAddress();
+	Ring = (uint8*)Region->GetAddress() + sizeof(FOvermindTelemetryHeader);
+	FMemory::Memzero(Header, sizeof(FOvermindTelemetryHeader));
+	Header->Version = FOvermindTelemetryHeader::CurrentVersion;
+	Header->HeaderSize = sizeof(FOvermindTelemetryHeader);
+	Header->Capacity = Capacity;
+	Header->ProcessId = FPlatformProcess::GetCurrentProcessId();
+	Header->LastFrameStart = -1;
+	WritePosition = 0;
+	Frame = 0;
+
+	// Readers look at the magic first, everything else has to be there before it.
+	FPlatformMisc::MemoryBarrier();
+	Header->Magic = FOvermindTelemetryHeader::ExpectedMagic;
+	return true;
+}
+
+void FOvermindTelemetry::Close()
+{
+	if (Region)
+	{
+		Header->Magic = 0;
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+		Header = nullptr;
+		Ring = nullptr;
+	}
+}
+
+void FOvermindTelemetry::AddPlayer(const FVector& Location, int32 Condition)
+{
+	FOvermindTelemetryPlayer& Player = Players.AddZeroed_GetRef();
+	Player.X = Location.X;
+	Player.Y = Location.Y;
+	Player.Z = Location.Z;
+	Player.Condition = (uint8)Condition;
+}
+
+void FOvermindTelemetry::AddEnemy(int32 Slot, const FVector& Location, int32 TargetPlayer, uint8 TypeIndex, uint8 State, bool bInCombat)
+{
+	FOvermindTelemetryEnemy& Enemy = Enemies.AddZeroed_GetRef();
+	Enemy.Slot = (int16)Slot;
+	Enemy.TargetPlayer = (int8)TargetPlayer;
+	Enemy.TypeIndex = TypeIndex;
+	Enemy.State = State;
+	Enemy.bInCombat = bInCombat;
+	Enemy.X = Location.X;
+	Enemy.Y = Location.Y;
+	Enemy.Z = Location.Z;
+}
+
+void FOvermindTelemetry::AddVisionCheck(int32 Slot, int32 Player, bool bVisible)
+{
+	FOvermindTelemetryVision& Check = VisionChecks.AddUninitialized_GetRef();
+	Check.Slot = (int16)Slot;
+	Check.Player = (uint8)Player;
+	Check.bVisible = bVisible;
+}
+
+void FOvermindTelemetry::AddSpawnAttempt(const FVector& Location, uint8 Result)
+{
+	FOvermindTelemetrySpawn& Attempt = SpawnAttempts.AddZeroed_GetRef();
+	Attempt.X = Location.X;
+	Attempt.Y = Location.Y;
+	Attempt.Z = Location.Z;
+	Attempt.Result = Result;
+}
+
+void FOvermindTelemetry::EndFrame(float WorldTime, float Milliseconds)
+{
+	++Frame;
+	if (Header)
+	{
+		FOvermindTelemetryFrame FrameHeader;
+		FrameHeader.Frame = Frame;
+		FrameHeader.WorldTime = WorldTime;
+		FrameHeader.Milliseconds = Milliseconds;
+		FrameHeader.NumPlayers = (uint16)FMath::Min<int32>(Players.Num(), MAX_uint16);
+		FrameHeader.NumEnemies = (uint16)FMath::Min<int32>(Enemies.Num(), MAX_uint16);
+		FrameHeader.NumVisionChecks = (uint16)FMath::Min<int32>(VisionChecks.Num(), MAX_uint16);
+		FrameHeader.NumSpawnAttempts = (uint16)FMath::Min<int32>(SpawnAttempts.Num(), MAX_uint16);
+		FrameHeader.Size = sizeof(FOvermindTelemetryFrame)
+			+ FrameHeader.NumPlayers * sizeof(FOvermindTelemetryPlayer) + FrameHeader.NumEnemies * sizeof(FOvermindTelemetryEnemy)
+			+ FrameHeader.NumVisionChecks * sizeof(FOvermindTelemetryVision) + FrameHeader.NumSpawnAttempts * sizeof(FOvermindTelemetrySpawn);
+
+		if (FrameHeader.Size > Capacity / 2)
+		{
+			// Would write over itself before anyone could read it.
+			FPlatformAtomics::AtomicStore(&Header->NumDropped, Header->NumDropped + 1);
+		}
+		else
+		{
+			// Claim the bytes first, a reader that copied any of them sees it and throws its copy away.
+			const int64 Start = WritePosition;
+			FPlatformAtomics::AtomicStore(&Header->Reserved, Start + FrameHeader.Size);
+			FPlatformMisc::MemoryBarrier();
+
+			int64 Position = Start;
+			WriteRing(Position, &FrameHeader, sizeof(FrameHeader));
+			Position += sizeof(FrameHeader);
+			WriteList(Position, Players, FrameHeader.NumPlayers);
+			WriteList(Position, Enemies, FrameHeader.NumEnemies);
+			WriteList(Position, VisionChecks, FrameHeader.NumVisionChecks);
+			WriteList(Position, SpawnAttempts, FrameHeader.NumSpawnAttempts);
+
+			// Publish the frame.
+			FPlatformMisc::MemoryBarrier();
+			FPlatformAtomics::AtomicStore(&Header->LastFrameStart, Start);
+			FPlatformAtomics::AtomicStore(&Header->NumFrames, Header->NumFrames + 1);
+			WritePosition = Start + FrameHeader.Size;
+		}
+	}
+
+	Players.Reset();
+	Enemies.Reset();
+	VisionChecks.Reset();
+	SpawnAttempts.Reset();
+}
+
+void FOvermindTelemetry::WriteRing(int64 Position, const void* Data, uint32 Size)
+{
+	const uint32 Offset = (uint32)(Position & (Capacity - 1));
+	const uint32 FirstPart = FMath::Min(Size, Capacity - Offset);
+	FMemory::Memcpy(Ring + Offset, Data, FirstPart);
+	if (Size > FirstPart)
+	{
+		FMemory::Memcpy(Ring, (const uint8*)Data + FirstPart, Size - FirstPart);
+	}
+}
+
+FOvermindTelemetryReader::FOvermindTelemetryReader() :
+	Region(nullptr), Header(nullptr), Ring(nullptr), Capacity(0), LastRead(-1)
+{
+}
+
+FOvermindTelemetryReader::~FOvermindTelemetryReader()
+{
+	Close();
+}
+
+bool FOvermindTelemetryReader::Open(const FString& Name)
+{
+	Close();
+
+	// The header says how big the ring is, map it alone first.
+	FPlatformMemory::FSharedMemoryRegion* HeaderRegion = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false, (uint32)FPlatformMemory::ESharedMemoryAccess::Read, sizeof(FOvermindTelemetryHeader));
+	if (!HeaderRegion)
+	{
+		return false;
+	}
+	const FOvermindTelemetryHeader* Peek = (const FOvermindTelemetryHeader*)HeaderRegion->GetAddress();
+	const bool bValid = Peek->Magic == FOvermindTelemetryHeader::ExpectedMagic && Peek->Version == FOvermindTelemetryHeader::CurrentVersion
+		&& Peek->HeaderSize == sizeof(FOvermindTelemetryHeader) && FMath::IsPowerOfTwo(Peek->Capacity);
+	const uint32 RingCapacity = Peek->Capacity;
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(HeaderRegion);
+	if (!bValid)
+	{
+		return false;
+	}
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false, (uint32)FPlatformMemory::ESharedMemoryAccess::Read, sizeof(FOvermindTelemetryHeader) + RingCapacity);
+	if (!Region)
+	{
+		return false;
+	}
+	Header = (const FOvermindTelemetryHeader*)Region->GetAddress();
+	Ring = (const uint8*)Region->GetAddress() + sizeof(FOvermindTelemetryHeader);
+	Capacity = RingCapacity;
+	LastRead = -1;
+	return true;
+}
+
+void FOvermindTelemetryReader::Close()
+{
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+		Header = nullptr;
+		Ring = nullptr;
+	}
+}
+
+bool FOvermindTelemetryReader::ReadLatest(FOvermindTelemetrySnapshot& OutSnapshot)
+{
+	if (!Header || Header->Magic != FOvermindTelemetryHeader::ExpectedMagic)
+	{
+		return false;
+	}
+
+	const int64 Start = FPlatformAtomics::AtomicRead(&Header->LastFrameStart);
+	if (Start < 0 || Start == LastRead)
+	{
+		return false;
+	}
+	FPlatformMisc::MemoryBarrier();
+
+	int64 Position = Start;
+	ReadRing(Position, &OutSnapshot.Frame, sizeof(FOvermindTelemetryFrame));
+	Position += sizeof(FOvermindTelemetryFrame);
+
+	// A header written over halfway can say anything, only trust counts that add up.
+	const FOvermindTelemetryFrame& Frame = OutSnapshot.Frame;
+	const uint64 ExpectedSize = sizeof(FOvermindTelemetryFrame)
+		+ Frame.NumPlayers * sizeof(FOvermindTelemetryPlayer) + Frame.NumEnemies * sizeof(FOvermindTelemetryEnemy)
+		+ Frame.NumVisionChecks * sizeof(FOvermindTelemetryVision) + Frame.NumSpawnAttempts * sizeof(FOvermindTelemetrySpawn);
+	if (Frame.Size != ExpectedSize || Frame.Size > Capacity / 2)
+	{
+		return false;
+	}
+
+	ReadList(Position, OutSnapshot.Players, Frame.NumPlayers);
+	ReadList(Position, OutSnapshot.Enemies, Frame.NumEnemies);
+	ReadList(Position, OutSnapshot.VisionChecks, Frame.NumVisionChecks);
+	ReadList(Position, OutSnapshot.SpawnAttempts, Frame.NumSpawnAttempts);
+
+	// If the writer claimed any of those bytes in the meantime the copy is torn.
+	FPlatformMisc::MemoryBarrier();
+	if (FPlatformAtomics::AtomicRead(&Header->Reserved) - Start > (int64)Capacity)
+	{
+		return false;
+	}
+
+	LastRead = Start;
+	return true;
+}
+
+int64 FOvermindTelemetryReader::GetNumFrames() const
+{
+	return Header ? FPlatformAtomics::AtomicRead(&Header->NumFrames) : 0;
+}
+
+int64 FOvermindTelemetryReader::GetNumDropped() const
+{
+	return Header ? FPlatformAtomics::AtomicRead(&Header->NumDropped) : 0;
+}
+
+void FOvermindTelemetryReader::ReadRing(int64 Position, void* Data, uint32 Size) const
+{
+	const uint32 Offset = (uint32)(Position & (Capacity - 1));
+	const uint32 FirstPart = FMath::Min(Size, Capacity - Offset);
+	FMemory::Memcpy(Data, Ring + Offset, FirstPart);
+	if (Size > FirstPart)
+	{
+		FMemory::Memcpy((uint8*)Data + FirstPart, Ring, Size - FirstPart);
+	}
+}
@@ -0,0 +1,199 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+
+// Start of the shared memory region. Counters are bytes written since the stream opened and only grow,
+// the position in the ring is the counter modulo Capacity.
+struct FOvermindTelemetryHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x544D564F; // "OVMT"
+	static constexpr uint16 CurrentVersion = 1;
+
+	uint32 Magic;
+	uint16 Version;
+	uint16 HeaderSize;
+	uint32 Capacity;
+	uint32 ProcessId;
+	// Everything before this has been handed to the writer, bytes in [Reserved - Capacity, Reserved) may be being written.
+	volatile int64 Reserved;
+	// Start of the last whole frame, -1 before the first one.
+	volatile int64 LastFrameStart;
+	volatile int64 NumFrames;
+	// Frames too big for the ring, they are never written.
+	volatile int64 NumDropped;
+	uint8 Padding[16];
+};
+static_assert(sizeof(FOvermindTelemetryHeader) == 64, "FOvermindTelemetryHeader is shared with other processes, keep it packed.");
+
+// One published frame, followed by NumPlayers players, NumEnemies enemies, NumVisionChecks checks and NumSpawnAttempts attempts.
+struct FOvermindTelemetryFrame
+{
+	// Whole frame in bytes, this header included.
+	uint32 Size;
+	uint32 Frame;
+	float WorldTime;
+	// Game thread time the Overmind took this frame.
+	float Milliseconds;
+	uint16 NumPlayers;
+	uint16 NumEnemies;
+	uint16 NumVisionChecks;
+	uint16 NumSpawnAttempts;
+};
+
+struct FOvermindTelemetryPlayer
+{
+	float X, Y, Z;
+	// PlayerCondition of this player, 1 to 4.
+	uint8 Condition;
+	uint8 Padding[3];
+};
+
+// Only enemies on the map are sent.
+struct FOvermindTelemetryEnemy
+{
+	int16 Slot;
+	// Index of the targeted player, -1 without a target.
+	int8 TargetPlayer;
+	// SpawnInfo index, 255 if unknown.
+	uint8 TypeIndex;
+	// State of the mob state machine, 255 when Blueprint drives the enemy.
+	uint8 State;
+	uint8 bInCombat;
+	uint8 Padding[2];
+	float X, Y, Z;
+};
+
+// An enemy looked at a player.
+struct FOvermindTelemetryVision
+{
+	int16 Slot;
+	uint8 Player;
+	uint8 bVisible;
+};
+
+// A spawn point the Overmind tried.
+struct FOvermindTelemetrySpawn
+{
+	float X, Y, Z;
+	// EOvermindSpawnReject, or EOvermindSpawnReject::Num if the point was taken.
+	uint8 Result;
+	uint8 Padding[3];
+};
+
+/**
+ * Publishes what the Overmind does each frame into a named shared memory ring, for a viewer in another process
+ * (-run=OvermindViewer) to draw. The writer never waits on readers, it just writes over the oldest frames,
+ * readers check afterwards whether the frame they copied was written over while they read it.
+ * Costs a few copies of the enemy list per frame and works the same on a dedicated server.
+ */
+class NIGHTFALL_API FOvermindTelemetry
+{
+public:
+	/**
+	* @param	InName: Name of the shared memory region, readers open the same name.
+	* @param	InCapacity: Size of the ring in bytes.
+	*/
+	FOvermindTelemetry(const FString& InName, uint32 InCapacity = 4 * 1024 * 1024);
+	~FOvermindTelemetry();
+
+	// Create the region, false if the platform would not give it or another running process already publishes under the name.
+	bool Open();
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Region != nullptr;
+	}
+
+	const FString& GetName() const
+	{
+		return Name;
+	}
+
+	// Collected during the frame, sent with the next EndFrame.
+	void AddPlayer(const FVector& Location, int32 Condition);
+	void AddEnemy(int32 Slot, const FVector& Location, int32 TargetPlayer, uint8 TypeIndex, uint8 State, bool bInCombat);
+	void AddVisionCheck(int32 Slot, int32 Player, bool bVisible);
+	void AddSpawnAttempt(const FVector& Location, uint8 Result);
+
+	// Write everything collected since the last call as one frame and start a new one.
+	void EndFrame(float WorldTime, float Milliseconds);
+
+private:
+
+	// Copy to the ring at Position, wrapping around its end.
+	void WriteRing(int64 Position, const void* Data, uint32 Size);
+
+	template<typename T>
+	void WriteList(int64& Position, const TArray<T>& List, int32 Count)
+	{
+		WriteRing(Position, List.GetData(), Count * sizeof(T));
+		Position += Count * sizeof(T);
+	}
+
+	FString Name;
+	uint32 Capacity;
+	FPlatformMemory::FSharedMemoryRegion* Region;
+	FOvermindTelemetryHeader* Header;
+	uint8* Ring;
+	int64 WritePosition;
+	uint32 Frame;
+
+	TArray<FOvermindTelemetryPlayer> Players;
+	TArray<FOvermindTelemetryEnemy> Enemies;
+	TArray<FOvermindTelemetryVision> VisionChecks;
+	TArray<FOvermindTelemetrySpawn> SpawnAttempts;
+};
+
+// A frame read back from the ring.
+struct FOvermindTelemetrySnapshot
+{
+	FOvermindTelemetryFrame Frame;
+	TArray<FOvermindTelemetryPlayer> Players;
+	TArray<FOvermindTelemetryEnemy> Enemies;
+	TArray<FOvermindTelemetryVision> VisionChecks;
+	TArray<FOvermindTelemetrySpawn> SpawnAttempts;
+};
+
+// Reading side of FOvermindTelemetry, for tools. Only ever reads the region, the writer does not know it is there.
+class NIGHTFALL_API FOvermindTelemetryReader
+{
+public:
+	FOvermindTelemetryReader();
+	~FOvermindTelemetryReader();
+
+	// Open a region a running Overmind created, false if there is none or it is not an Overmind stream.
+	bool Open(const FString& Name);
+	void Close();
+
+	/**
+	* Copy the newest frame.
+	* @return	False if there is no frame newer than the last one read, or if it was written over while being copied (try again).
+	*/
+	bool ReadLatest(FOvermindTelemetrySnapshot& OutSnapshot);
+
+	// Frames the writer sent and frames it had to drop, as far as the header says.
+	int64 GetNumFrames() const;
+	int64 GetNumDropped() const;
+
+private:
+
+	void ReadRing(int64 Position, void* Data, uint32 Size) const;
+
+	template<typename T>
+	void ReadList(int64& Position, TArray<T>& List, int32 Count) const
+	{
+		List.SetNumUninitialized(Count);
+		ReadRing(Position, List.GetData(), Count * sizeof(T));
+		Position += Count * sizeof(T);
+	}
+
+	FPlatformMemory::FSharedMemoryRegion* Region;
+	const FOvermindTelemetryHeader* Header;
+	const uint8* Ring;
+	uint32 Capacity;
+	int64 LastRead;
+};
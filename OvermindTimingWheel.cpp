@@ -0,0 +1,155 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindTimingWheel.h"
+
+FOvermindTimingWheel::FOvermindTimingWheel() :
+	CurrentTick(0), TickInterval(0.05f), NumPendingEntries(0)
+{
+}
+
+void FOvermindTimingWheel::Reset(float InTickInterval, float Now)
+{
+	TickInterval = FMath::Max(InTickInterval, KINDA_SMALL_NUMBER);
+	CurrentTick = (uint64)FMath::Max(FMath::FloorToFloat(Now / TickInterval), 0.0f);
+	NumPendingEntries = 0;
+
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		for (int32 Slot = 0; Slot < SlotsPerLevel; ++Slot)
+		{
+			Slots[Level][Slot].Reset();
+		}
+	}
+	ReadyMasks.Reset();
+	Generations.Reset();
+}
+
+void FOvermindTimingWheel::SetNumOwners(int32 NumOwners)
+{
+	if (NumOwners > ReadyMasks.Num())
+	{
+		ReadyMasks.AddZeroed(NumOwners - ReadyMasks.Num());
+		Generations.AddZeroed(NumOwners - Generations.Num());
+	}
+}
+
+void FOvermindTimingWheel::ResetOwner(int32 Owner, int32 NumAbilities)
+{
+	SetNumOwners(Owner + 1);
+
+	// Anything still on the wheel for this owner is now stale and will be ignored when it expires.
+	Generations[Owner]++;
+
+	NumAbilities = FMath::Clamp(NumAbilities, 0, MaxAbilitiesPerOwner);
+	ReadyMasks[Owner] = NumAbilities == MaxAbilitiesPerOwner ? MAX_uint32 : ((1u << NumAbilities) - 1);
+}
+
+void FOvermindTimingWheel::Schedule(int32 Owner, int32 Ability, float ReadyTime)
+{
+	if (!ReadyMasks.IsValidIndex(Owner) || Ability < 0 || Ability >= MaxAbilitiesPerOwner)
+	{
+		return;
+	}
+
+	ReadyMasks[Owner] &= ~(1u << Ability);
+
+	FEntry Entry;
+	Entry.ReadyTick = (uint64)FMath::Max(FMath::CeilToFloat(ReadyTime / TickInterval), 0.0f);
+	Entry.Owner = Owner;
+	Entry.Generation = Generations[Owner];
+	Entry.Ability = (uint8)Ability;
+
+	NumPendingEntries++;
+	Insert(Entry);
+}
+
+void FOvermindTimingWheel::Advance(float Now)
+{
+	const uint64 TargetTick = (uint64)FMath::Max(FMath::FloorToFloat(Now / TickInterval), 0.0f);
+
+	while (CurrentTick < TargetTick)
+	{
+		// Nothing waiting, no reason to walk the slots.
+		if (NumPendingEntries == 0)
+		{
+			CurrentTick = TargetTick;
+			break;
+		}
+
+		++CurrentTick;
+
+		// Find the highest level that just wrapped around and cascade from there down, so entries coming from
+		// level 2 land on the level 1 slot that is cascaded right after.
+		int32 HighestLevel = 0;
+		for (int32 Level = 1; Level < NumLevels; ++Level)
+		{
+			if ((CurrentTick & ((1ull << (SlotBits * Level)) - 1)) != 0)
+			{
+				break;
+			}
+			HighestLevel = Level;
+		}
+		for (int32 Level = HighestLevel; Level > 0; --Level)
+		{
+			Cascade(Level);
+		}
+
+		TArray<FEntry>& Slot = Slots[0][CurrentTick & SlotMask];
+		for (int32 i = 0; i < Slot.Num(); ++i)
+		{
+			Expire(Slot[i]);
+		}
+		NumPendingEntries -= Slot.Num();
+		Slot.Reset();
+	}
+}
+
+void FOvermindTimingWheel::Insert(const FEntry& Entry)
+{
+	// Already done? Don't bother with the wheel.
+	if (Entry.ReadyTick <= CurrentTick)
+	{
+		Expire(Entry);
+		NumPendingEntries--;
+		return;
+	}
+
+	uint64 Delta = Entry.ReadyTick - CurrentTick;
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		if (Delta < (1ull << (SlotBits * (Level + 1))))
+		{
+			Slots[Level][(Entry.ReadyTick >> (SlotBits * Level)) & SlotMask].Add(Entry);
+			return;
+		}
+	}
+
+	// Too far in the future for the wheel, park it on the last slot it can reach. It goes back up when that slot is cascaded.
+	const uint64 ParkedTick = CurrentTick + (1ull << (SlotBits * NumLevels)) - 1;
+	Slots[NumLevels - 1][(ParkedTick >> (SlotBits * (NumLevels - 1))) & SlotMask].Add(Entry);
+}
+
+void FOvermindTimingWheel::Cascade(int32 Level)
+{
+	TArray<FEntry>& Slot = Slots[Level][(CurrentTick >> (SlotBits * Level)) & SlotMask];
+	if (Slot.Num() == 0)
+	{
+		return;
+	}
+
+	Swap(CascadeBuffer, Slot);
+	for (int32 i = 0; i < CascadeBuffer.Num(); ++i)
+	{
+		Insert(CascadeBuffer[i]);
+	}
+	CascadeBuffer.Reset();
+}
+
+void FOvermindTimingWheel::Expire(const FEntry& Entry)
+{
+	if (Generations[Entry.Owner] == Entry.Generation)
+	{
+		ReadyMasks[Entry.Owner] |= (1u << Entry.Ability);
+	}
+}
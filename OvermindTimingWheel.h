@@ -0,0 +1,90 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hierarchical timing wheel used by the Overmind to track enemy ability cooldowns.
+ * Abilities are registered with the time they become ready and are moved to a ready mask when they expire,
+ * so Advance only pays for the abilities that actually expire instead of every enemy and every ability.
+ */
+class NIGHTFALL_API FOvermindTimingWheel
+{
+public:
+	// One bit per ability on the ready mask.
+	static constexpr int32 MaxAbilitiesPerOwner = 32;
+
+	FOvermindTimingWheel();
+
+	/**
+	* Clear every owner and pending cooldown.
+	* @param	InTickInterval: Resolution of the wheel in seconds.
+	* @param	Now: Current world time, used as the start of the wheel.
+	*/
+	void Reset(float InTickInterval, float Now);
+
+	// Make sure the wheel knows about owners up to (but not including) NumOwners.
+	void SetNumOwners(int32 NumOwners);
+
+	// Mark every ability of this owner as ready and forget its pending cooldowns.
+	void ResetOwner(int32 Owner, int32 NumAbilities);
+
+	// Remove an ability from the ready mask until ReadyTime.
+	void Schedule(int32 Owner, int32 Ability, float ReadyTime);
+
+	// Move the wheel forward to Now, expiring whatever cooldowns are done.
+	void Advance(float Now);
+
+	// Bit mask of the abilities that are ready to be used.
+	FORCEINLINE uint32 GetReadyMask(int32 Owner) const
+	{
+		return ReadyMasks.IsValidIndex(Owner) ? ReadyMasks[Owner] : 0;
+	}
+
+	FORCEINLINE bool IsReady(int32 Owner, int32 Ability) const
+	{
+		return (GetReadyMask(Owner) & (1u << Ability)) != 0;
+	}
+
+	// How many cooldowns are still waiting on the wheel (including ones from owners that were reset).
+	FORCEINLINE int32 NumPending() const
+	{
+		return NumPendingEntries;
+	}
+
+private:
+
+	struct FEntry
+	{
+		uint64 ReadyTick;
+		int32 Owner;
+		uint16 Generation;
+		uint8 Ability;
+	};
+
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+	static constexpr int32 SlotMask = SlotsPerLevel - 1;
+	static constexpr int32 NumLevels = 4;
+
+	// Put an entry on the level that covers its distance from CurrentTick.
+	void Insert(const FEntry& Entry);
+
+	// Move every entry of a slot from a higher level down to the lower levels.
+	void Cascade(int32 Level);
+
+	// Cooldown is done, flag the ability as ready unless the owner was reset in the meantime.
+	void Expire(const FEntry& Entry);
+
+	TArray<FEntry> Slots[NumLevels][SlotsPerLevel];
+	// Scratch space used while cascading, kept around so it does not allocate every time.
+	TArray<FEntry> CascadeBuffer;
+
+	TArray<uint32> ReadyMasks;
+	TArray<uint16> Generations;
+
+	uint64 CurrentTick;
+	float TickInterval;
+	int32 NumPendingEntries;
+};
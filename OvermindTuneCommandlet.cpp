@@ -0,0 +1,208 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindTuneCommandlet.h"
+#include "OvermindSimulation.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// "-Name=1,2.5,3" as a list of values, the default alone if the switch is not there.
+	TArray<float> ParseFloatList(const FString& Params, const TCHAR* Name, float Default)
+	{
+		TArray<float> Values;
+		FString Text;
+		if (FParse::Value(*Params, *FString::Printf(TEXT("%s="), Name), Text, false))
+		{
+			TArray<FString> Parts;
+			Text.ParseIntoArray(Parts, TEXT(","));
+			for (const FString& Part : Parts)
+			{
+				Values.Add(FCString::Atof(*Part));
+			}
+		}
+		if (Values.Num() == 0)
+		{
+			Values.Add(Default);
+		}
+		return Values;
+	}
+
+	// "-Weights=70:30,50:50", one weight per SpawnInfo entry for each set.
+	TArray<TArray<float>> ParseWeights(const FString& Params, const TArray<FEnemySpawnInfo>& SpawnInfo)
+	{
+		TArray<TArray<float>> Sets;
+		FString Text;
+		if (FParse::Value(*Params, TEXT("Weights="), Text, false))
+		{
+			TArray<FString> Parts;
+			Text.ParseIntoArray(Parts, TEXT(","));
+			for (const FString& Part : Parts)
+			{
+				TArray<FString> Numbers;
+				Part.ParseIntoArray(Numbers, TEXT(":"));
+				TArray<float>& Set = Sets.AddDefaulted_GetRef();
+				for (const FString& Number : Numbers)
+				{
+					Set.Add(FCString::Atof(*Number));
+				}
+			}
+		}
+		if (Sets.Num() == 0)
+		{
+			TArray<float>& Set = Sets.AddDefaulted_GetRef();
+			for (const FEnemySpawnInfo& Info : SpawnInfo)
+			{
+				Set.Add(Info.Weight);
+			}
+		}
+		return Sets;
+	}
+
+	FString WeightsToString(const TArray<float>& Weights)
+	{
+		FString Result;
+		for (int32 i = 0; i < Weights.Num(); ++i)
+		{
+			Result += FString::Printf(i == 0 ? TEXT("%g") : TEXT(":%g"), Weights[i]);
+		}
+		return Result;
+	}
+}
+
+UOvermindTuneCommandlet::UOvermindTuneCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UOvermindTuneCommandlet::Main(const FString& Params)
+{
+	FOvermindSimulationSettings Base;
+	FString OvermindPath;
+	if (FParse::Value(*Params, TEXT("overmind="), OvermindPath))
+	{
+		UClass* OvermindClass = LoadClass<AOvermindBase>(nullptr, *OvermindPath);
+		if (!OvermindClass)
+		{
+			UE_LOG(LogOvermind, Error, TEXT("OvermindTune: %s is not an Overmind class"), *OvermindPath);
+			return 1;
+		}
+		Base = FOvermindSimulationSettings::FromOvermind(*OvermindClass->GetDefaultObject<AOvermindBase>());
+	}
+	if (Base.SpawnInfo.Num() == 0)
+	{
+		// No Overmind to take types from, two made up ones so weights still mean something.
+		FEnemySpawnInfo Info;
+		Info.Weight = 70.0f;
+		Info.Quantity = 40;
+		Base.SpawnInfo.Add(Info);
+		Info.Weight = 30.0f;
+		Info.Quantity = 20;
+		Base.SpawnInfo.Add(Info);
+	}
+
+	FParse::Value(*Params, TEXT("players="), Base.NumPlayers);
+	FParse::Value(*Params, TEXT("duration="), Base.Duration);
+	int32 NumSeeds = 4;
+	FParse::Value(*Params, TEXT("seeds="), NumSeeds);
+	NumSeeds = FMath::Max(NumSeeds, 1);
+
+	const TArray<float> Cooldowns = ParseFloatList(Params, TEXT("CooldownSpawn"), Base.CooldownSpawn);
+	const TArray<float> InnerRadii = ParseFloatList(Params, TEXT("InnerSpawnRadius"), Base.InnerSpawnRadius);
+	const TArray<float> OuterRadii = ParseFloatList(Params, TEXT("OuterSpawnRadius"), Base.OuterSpawnRadius);
+	const TArray<float> KillRanges = ParseFloatList(Params, TEXT("KillEnemyRange"), Base.KillEnemyRange);
+	const TArray<float> Recycles = ParseFloatList(Params, TEXT("Recycle"), Base.bRecycleOutOfRangeEnemies ? 1.0f : 0.0f);
+	const TArray<TArray<float>> WeightSets = ParseWeights(Params, Base.SpawnInfo);
+
+	// Every combination, every seed, as its own run.
+	TArray<FOvermindSimulationSettings> Runs;
+	for (float Cooldown : Cooldowns)
+	for (float InnerRadius : InnerRadii)
+	for (float OuterRadius : OuterRadii)
+	for (float KillRange : KillRanges)
+	for (float Recycle : Recycles)
+	for (const TArray<float>& Weights : WeightSets)
+	{
+		for (int32 Seed = 0; Seed < NumSeeds; ++Seed)
+		{
+			FOvermindSimulationSettings& Run = Runs.Add_GetRef(Base);
+			Run.CooldownSpawn = Cooldown;
+			Run.InnerSpawnRadius = InnerRadius;
+			Run.OuterSpawnRadius = OuterRadius;
+			Run.KillEnemyRange = KillRange;
+			Run.bRecycleOutOfRangeEnemies = Recycle != 0.0f;
+			for (int32 i = 0; i < Run.SpawnInfo.Num() && i < Weights.Num(); ++i)
+			{
+				Run.SpawnInfo[i].Weight = Weights[i];
+			}
+			Run.Seed = Seed + 1;
+		}
+	}
+
+	UE_LOG(LogOvermind, Display, TEXT("OvermindTune: %d combinations x %d seeds, %.0f simulated seconds each"), Runs.Num() / NumSeeds, NumSeeds, Base.Duration);
+
+	// Runs share nothing, one per task.
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<FOvermindSimulationResult> Results;
+	Results.SetNum(Runs.Num());
+	ParallelFor(Runs.Num(), [&Runs, &Results](int32 Index)
+	{
+		FOvermindSimulation Simulation(Runs[Index]);
+		Results[Index] = Simulation.Run();
+	});
+	const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// One line per combination, seeds averaged.
+	TArray<FString> CsvLines;
+	CsvLines.Add(TEXT("CooldownSpawn,InnerSpawnRadius,OuterSpawnRadius,KillEnemyRange,Recycle,Weights,SpawnsPerMinute,RangeDespawnsPerMinute,ChurnedSpawnsPerMinute,RecyclesPerMinute,KillsPerMinute,PlayerDeathsPerMinute,PoolMissesPerMinute,RejectedPointsPerMinute,NavQueriesPerMinute,TracesPerMinute,PoolUtilization,PeakActive,CpuMsPerRun,SpeedUp"));
+	for (int32 First = 0; First < Runs.Num(); First += NumSeeds)
+	{
+		float Sums[10] = { 0 };
+		float PoolUtilization = 0.0f;
+		int32 PeakActive = 0;
+		double CpuSeconds = 0.0;
+		float SimulatedSeconds = 0.0f;
+		for (int32 Index = First; Index < First + NumSeeds; ++Index)
+		{
+			const FOvermindSimulationResult& Result = Results[Index];
+			const int32 Counts[] = { Result.NumSpawns, Result.NumRangeDespawns, Result.NumChurnedSpawns, Result.NumRecycles, Result.NumKills,
+				Result.NumPlayerDeaths, Result.NumPoolMisses, Result.NumRejectedPoints, Result.NumNavQueries, Result.NumTraces };
+			for (int32 i = 0; i < (int32)UE_ARRAY_COUNT(Counts); ++i)
+			{
+				Sums[i] += Result.PerMinute(Counts[i]) / NumSeeds;
+			}
+			PoolUtilization += Result.PoolUtilization / NumSeeds;
+			PeakActive = FMath::Max(PeakActive, Result.PeakActive);
+			CpuSeconds += Result.CpuSeconds / NumSeeds;
+			SimulatedSeconds += Result.SimulatedSeconds / NumSeeds;
+		}
+
+		const FOvermindSimulationSettings& Run = Runs[First];
+		TArray<float> Weights;
+		for (const FEnemySpawnInfo& Info : Run.SpawnInfo)
+		{
+			Weights.Add(Info.Weight);
+		}
+		CsvLines.Add(FString::Printf(TEXT("%g,%g,%g,%g,%d,%s,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%d,%.3f,%.0f"),
+			Run.CooldownSpawn, Run.InnerSpawnRadius, Run.OuterSpawnRadius, Run.KillEnemyRange, Run.bRecycleOutOfRangeEnemies ? 1 : 0, *WeightsToString(Weights),
+			Sums[0], Sums[1], Sums[2], Sums[3], Sums[4], Sums[5], Sums[6], Sums[7], Sums[8], Sums[9],
+			PoolUtilization, PeakActive, CpuSeconds * 1000.0, CpuSeconds > 0.0 ? SimulatedSeconds / CpuSeconds : 0.0));
+	}
+
+	FString OutputFile = FPaths::ProjectSavedDir() / TEXT("Automation") / FString::Printf(TEXT("OvermindTune_%s.csv"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("output="), OutputFile);
+	if (!FFileHelper::SaveStringArrayToFile(CsvLines, *OutputFile))
+	{
+		UE_LOG(LogOvermind, Error, TEXT("OvermindTune: Could not write %s"), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogOvermind, Display, TEXT("OvermindTune: %d runs in %.2f s (%.0f simulated seconds per real second), results in %s"),
+		Runs.Num(), WallSeconds, WallSeconds > 0.0 ? Runs.Num() * Base.Duration / WallSeconds : 0.0, *OutputFile);
+	return 0;
+}
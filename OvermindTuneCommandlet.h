@@ -0,0 +1,25 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "OvermindTuneCommandlet.generated.h"
+
+/**
+ * Sweeps Overmind settings through FOvermindSimulation, every combination on its own core, and writes a CSV line per combination.
+ * Usage: UE4Editor-Cmd Nightfall -run=OvermindTune -nullrhi [-overmind=<Overmind class path>] [-CooldownSpawn=0.5,1,2]
+ *        [-InnerSpawnRadius=..] [-OuterSpawnRadius=..] [-KillEnemyRange=..] [-Weights=70:30,50:50] [-Recycle=0,1]
+ *        [-players=4] [-duration=600] [-seeds=4] [-output=<csv>]
+ * Settings not swept keep the values of the Overmind class (or of FOvermindSimulationSettings without one).
+ */
+UCLASS()
+class NIGHTFALL_API UOvermindTuneCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UOvermindTuneCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,165 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindViewerCommandlet.h"
+#include "OvermindBase.h"
+#include "OvermindTelemetry.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/FileManager.h"
+
+namespace
+{
+	// Top down view of a frame, centered on the players. Players are their index, enemies e (E in combat), spawn points + taken, x rejected.
+	void LogMap(const FOvermindTelemetrySnapshot& Snapshot, float Scale)
+	{
+		const int32 Width = 64;
+		const int32 Height = 32;
+
+		FVector2D Center(0.0f, 0.0f);
+		for (const FOvermindTelemetryPlayer& Player : Snapshot.Players)
+		{
+			Center += FVector2D(Player.X, Player.Y) / Snapshot.Players.Num();
+		}
+
+		TArray<FString> Rows;
+		Rows.Init(FString::ChrN(Width, TEXT('.')), Height);
+		auto Plot = [&](float X, float Y, TCHAR Symbol)
+		{
+			// Cells are twice as tall as wide in a terminal.
+			const int32 Column = FMath::FloorToInt((X - Center.X) / Scale) + Width / 2;
+			const int32 Row = FMath::FloorToInt((Y - Center.Y) / (Scale * 2.0f)) + Height / 2;
+			if (Column >= 0 && Column < Width && Row >= 0 && Row < Height)
+			{
+				Rows[Row][Column] = Symbol;
+			}
+		};
+
+		for (const FOvermindTelemetrySpawn& Attempt : Snapshot.SpawnAttempts)
+		{
+			Plot(Attempt.X, Attempt.Y, Attempt.Result == (uint8)EOvermindSpawnReject::Num ? TEXT('+') : TEXT('x'));
+		}
+		for (const FOvermindTelemetryEnemy& Enemy : Snapshot.Enemies)
+		{
+			Plot(Enemy.X, Enemy.Y, Enemy.bInCombat ? TEXT('E') : TEXT('e'));
+		}
+		for (int32 i = 0; i < Snapshot.Players.Num(); ++i)
+		{
+			Plot(Snapshot.Players[i].X, Snapshot.Players[i].Y, TEXT('0') + (i % 10));
+		}
+
+		for (const FString& Row : Rows)
+		{
+			UE_LOG(LogOvermind, Display, TEXT("  %s"), *Row);
+		}
+	}
+}
+
+UOvermindViewerCommandlet::UOvermindViewerCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UOvermindViewerCommandlet::Main(const FString& Params)
+{
+	FString Name;
+	if (!FParse::Value(*Params, TEXT("name="), Name))
+	{
+		UE_LOG(LogOvermind, Error, TEXT("OvermindViewer: Missing -name=<region>, the Overmind logs it when it starts publishing"));
+		return 1;
+	}
+
+	float Hz = 10.0f;
+	float Seconds = 0.0f;
+	float Scale = 250.0f;
+	FParse::Value(*Params, TEXT("hz="), Hz);
+	FParse::Value(*Params, TEXT("seconds="), Seconds);
+	FParse::Value(*Params, TEXT("scale="), Scale);
+	const bool bMap = FParse::Param(*Params, TEXT("map"));
+	FString CsvFile;
+	const bool bCsv = FParse::Value(*Params, TEXT("csv="), CsvFile);
+	const float Interval = 1.0f / FMath::Max(Hz, 0.1f);
+
+	// Lines go to the file as frames come in, without -seconds the viewer runs until it is closed and nothing may come after the loop.
+	TUniquePtr<FArchive> Csv;
+	auto WriteCsvLine = [&Csv](const FString& Line)
+	{
+		FTCHARToUTF8 Utf8(*(Line + LINE_TERMINATOR));
+		Csv->Serialize((void*)Utf8.Get(), Utf8.Length());
+		Csv->Flush();
+	};
+	if (bCsv)
+	{
+		Csv.Reset(IFileManager::Get().CreateFileWriter(*CsvFile));
+		if (!Csv)
+		{
+			UE_LOG(LogOvermind, Error, TEXT("OvermindViewer: Could not write %s"), *CsvFile);
+			return 1;
+		}
+		WriteCsvLine(TEXT("Frame,WorldTime,OvermindMs,Players,Enemies,InCombat,VisionChecks,Visible,SpawnAttempts,SpawnsTaken"));
+	}
+
+	// The game may not be up yet, wait for it.
+	FOvermindTelemetryReader Reader;
+	const double StartTime = FPlatformTime::Seconds();
+	while (!Reader.Open(Name))
+	{
+		if (IsEngineExitRequested())
+		{
+			return 0;
+		}
+		if (Seconds > 0.0f && FPlatformTime::Seconds() - StartTime > Seconds)
+		{
+			UE_LOG(LogOvermind, Error, TEXT("OvermindViewer: No Overmind publishing to %s"), *Name);
+			return 1;
+		}
+		FPlatformProcess::Sleep(0.5f);
+	}
+	UE_LOG(LogOvermind, Display, TEXT("OvermindViewer: Watching %s"), *Name);
+
+	FOvermindTelemetrySnapshot Snapshot;
+	while ((Seconds <= 0.0f || FPlatformTime::Seconds() - StartTime < Seconds) && !IsEngineExitRequested())
+	{
+		FPlatformProcess::Sleep(Interval);
+		if (!Reader.ReadLatest(Snapshot))
+		{
+			// Either nothing new, or the writer lapped the copy. Only the newest frame matters, try on the next tick.
+			continue;
+		}
+
+		int32 InCombat = 0;
+		for (const FOvermindTelemetryEnemy& Enemy : Snapshot.Enemies)
+		{
+			InCombat += Enemy.bInCombat;
+		}
+		int32 Visible = 0;
+		for (const FOvermindTelemetryVision& Check : Snapshot.VisionChecks)
+		{
+			Visible += Check.bVisible;
+		}
+		int32 SpawnsTaken = 0;
+		for (const FOvermindTelemetrySpawn& Attempt : Snapshot.SpawnAttempts)
+		{
+			SpawnsTaken += Attempt.Result == (uint8)EOvermindSpawnReject::Num;
+		}
+
+		const FOvermindTelemetryFrame& Frame = Snapshot.Frame;
+		UE_LOG(LogOvermind, Display, TEXT("[frame %u, %.1f s] %.3f ms, %d players, %d enemies (%d in combat), vision %d/%d, spawn points %d/%d"),
+			Frame.Frame, Frame.WorldTime, Frame.Milliseconds, Frame.NumPlayers, Frame.NumEnemies, InCombat,
+			Visible, Frame.NumVisionChecks, SpawnsTaken, Frame.NumSpawnAttempts);
+		if (bMap)
+		{
+			LogMap(Snapshot, FMath::Max(Scale, 1.0f));
+		}
+		if (Csv)
+		{
+			WriteCsvLine(FString::Printf(TEXT("%u,%.3f,%.4f,%d,%d,%d,%d,%d,%d,%d"), Frame.Frame, Frame.WorldTime, Frame.Milliseconds,
+				Frame.NumPlayers, Frame.NumEnemies, InCombat, Frame.NumVisionChecks, Visible, Frame.NumSpawnAttempts, SpawnsTaken));
+		}
+	}
+
+	UE_LOG(LogOvermind, Display, TEXT("OvermindViewer: Writer sent %lld frames, dropped %lld"), Reader.GetNumFrames(), Reader.GetNumDropped());
+	return 0;
+}
@@ -0,0 +1,23 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "OvermindViewerCommandlet.generated.h"
+
+/**
+ * Watches the telemetry a running Overmind publishes (bPublishTelemetry or StartTelemetry) from another process.
+ * Usage: UE4Editor-Cmd Nightfall -run=OvermindViewer -name=<region> [-hz=10] [-seconds=0] [-map] [-scale=250] [-csv=<file>]
+ * Prints a line per frame it catches, -map adds a top down view around the players, -csv keeps every caught frame.
+ */
+UCLASS()
+class NIGHTFALL_API UOvermindViewerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UOvermindViewerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
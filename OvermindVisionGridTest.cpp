@@ -0,0 +1,91 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindVisionGridTest.h"
+#include "OvermindVoxelGrid.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+
+// Engine cube, 100 units on every side.
+static const float CubeSize = 100.0f;
+static const float FloorThickness = 20.0f;
+
+AOvermindVisionGridTest::AOvermindVisionGridTest() :
+	VoxelSize(100.0f), FloorLength(3000.0f), EyeHeight(90.0f), SlopeDegrees(15.0f)
+{
+	TimeLimit = 60.0f;
+}
+
+void AOvermindVisionGridTest::StartTest()
+{
+	Super::StartTest();
+
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!Cube)
+	{
+		FinishTest(EFunctionalTestResult::Error, TEXT("Could not load /Engine/BasicShapes/Cube"));
+		return;
+	}
+
+	// Floors fill a whole row of voxels, wherever the surface lands inside a voxel sight along the floor has to stay clear.
+	bool bPassed = true;
+	const float OffsetStep = VoxelSize / 4.0f;
+	for (float Offset = 0.0f; Offset < VoxelSize; Offset += OffsetStep)
+	{
+		bPassed &= CheckFloor(Cube, Offset, 0.0f, false);
+		bPassed &= CheckFloor(Cube, Offset, SlopeDegrees, false);
+	}
+	bPassed &= CheckFloor(Cube, 0.0f, 0.0f, true);
+
+	FinishTest(bPassed ? EFunctionalTestResult::Succeeded : EFunctionalTestResult::Failed, bPassed ? FString() : TEXT("Vision grid got line of sight wrong, see errors"));
+}
+
+bool AOvermindVisionGridTest::CheckFloor(UStaticMesh* Cube, float FloorOffset, float Pitch, bool bWall)
+{
+	const FRotator Rotation(Pitch, 0.0f, 0.0f);
+	const FVector Along = Rotation.RotateVector(FVector::ForwardVector);
+	const FVector Up = Rotation.RotateVector(FVector::UpVector);
+	const FVector Surface = GetActorLocation() + FVector(0.0f, 0.0f, FloorOffset);
+	const float Width = VoxelSize * 6.0f;
+
+	TArray<AStaticMeshActor*> Blocks;
+	auto SpawnBlock = [&](const FVector& Center, const FVector& Size)
+	{
+		AStaticMeshActor* Block = GetWorld()->SpawnActor<AStaticMeshActor>(Center, Rotation);
+		Block->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		Block->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Block->SetActorScale3D(Size / CubeSize);
+		Blocks.Add(Block);
+	};
+	SpawnBlock(Surface - Up * (FloorThickness * 0.5f), FVector(FloorLength, Width, FloorThickness));
+	if (bWall)
+	{
+		SpawnBlock(Surface + Up * (EyeHeight * 2.0f), FVector(FloorThickness * 2.0f, Width, EyeHeight * 4.0f));
+	}
+
+	// Grid just around the floor, its origin stays put so the floor surface moves inside the voxels.
+	const float Rise = FloorLength * 0.5f * FMath::Abs(FMath::Sin(FMath::DegreesToRadians(Pitch)));
+	const FVector Extent(FloorLength * 0.5f + VoxelSize, Width * 0.5f + VoxelSize, Rise + EyeHeight * 5.0f);
+	const FVector GridCenter = GetActorLocation() + FVector(0.0f, 0.0f, EyeHeight);
+	FOvermindVoxelGrid Grid;
+	Grid.Init(FBox(GridCenter - Extent, GridCenter + Extent), VoxelSize);
+	Grid.Bake(GetWorld());
+
+	const FVector From = Surface - Along * (FloorLength * 0.4f) + Up * EyeHeight;
+	const FVector To = Surface + Along * (FloorLength * 0.4f) + Up * EyeHeight;
+	const bool bSight = Grid.HasLineOfSight(From, To) && Grid.HasLineOfSight(To, From);
+
+	for (AStaticMeshActor* Block : Blocks)
+	{
+		Block->Destroy();
+	}
+
+	if (bSight == bWall)
+	{
+		AddError(FString::Printf(TEXT("Floor %.0f units into a voxel, slope %.0f, %s: expected %s, %d voxels occupied"),
+			FloorOffset, Pitch, bWall ? TEXT("wall") : TEXT("no wall"), bWall ? TEXT("blocked") : TEXT("clear"), Grid.GetNumOccupied()));
+		return false;
+	}
+	return true;
+}
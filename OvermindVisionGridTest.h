@@ -0,0 +1,48 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FunctionalTest.h"
+#include "OvermindVisionGridTest.generated.h"
+
+class UStaticMesh;
+
+/**
+ * Functional test of the vision grid bake: builds a floor out of the engine cube around the test, bakes a grid over it
+ * and checks two enemies standing on it see each other, on a flat floor and on a slope, with the floor surface at every
+ * height inside a voxel. A wall between them has to block. Place it far from any other geometry on a test map.
+ */
+UCLASS()
+class NIGHTFALL_API AOvermindVisionGridTest : public AFunctionalTest
+{
+	GENERATED_BODY()
+
+public:
+	AOvermindVisionGridTest();
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test", meta = (ClampMin = "10.0", UIMin = "10.0"))
+		float VoxelSize;
+
+	// Length of the floor, the two points are near its ends.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test", meta = (ClampMin = "100.0", UIMin = "100.0"))
+		float FloorLength;
+
+	// Height of the points above the floor, about where an enemy's capsule center is.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float EyeHeight;
+
+	// Slope of the second floor, in degrees.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Overmind Test")
+		float SlopeDegrees;
+
+	virtual void StartTest() override;
+
+private:
+
+	/**
+	* Spawn a floor with its surface FloorOffset above the test, optionally with a wall across the middle, bake and look across it.
+	* @return	True if sight was what it should be.
+	*/
+	bool CheckFloor(UStaticMesh* Cube, float FloorOffset, float Pitch, bool bWall);
+};
@@ -0,0 +1,252 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "OvermindVoxelGrid.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FOvermindVoxelGrid::Init(const FBox& Bounds, float InVoxelSize)
+{
+	VoxelSize = FMath::Max(InVoxelSize, 1.0f);
+	Origin = Bounds.Min;
+	const FVector Size = Bounds.GetSize();
+	Dimensions = FIntVector(
+		FMath::Max(FMath::CeilToInt(Size.X / VoxelSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Y / VoxelSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Z / VoxelSize), 1));
+	ChunkDimensions = FIntVector(
+		FMath::DivideAndRoundUp(Dimensions.X, ChunkSize),
+		FMath::DivideAndRoundUp(Dimensions.Y, ChunkSize),
+		FMath::DivideAndRoundUp(Dimensions.Z, ChunkSize));
+
+	Chunks.Reset();
+	Chunks.AddZeroed(ChunkDimensions.X * ChunkDimensions.Y * ChunkDimensions.Z);
+	NumOccupied = 0;
+	NextBakeChunk = 0;
+	bBaked = false;
+}
+
+void FOvermindVoxelGrid::Bake(UWorld* World, ECollisionChannel Channel)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	// From scratch, even if it was baked before.
+	FMemory::Memzero(Chunks.GetData(), Chunks.Num() * sizeof(uint64));
+	NextBakeChunk = 0;
+	NumOccupied = 0;
+	bBaked = false;
+	while (!BakeStep(World, MAX_int32, Channel))
+	{
+	}
+}
+
+bool FOvermindVoxelGrid::BakeStep(UWorld* World, int32 MaxChunks, ECollisionChannel Channel)
+{
+	if (bBaked)
+	{
+		return true;
+	}
+	if (!World)
+	{
+		return false;
+	}
+
+	const FCollisionObjectQueryParams ObjectParams(Channel);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(OvermindVoxelBake), false);
+	const float ChunkWorldSize = ChunkSize * VoxelSize;
+	// A hair smaller than the chunk, geometry that only touches a face does not count.
+	const FCollisionShape ChunkShape = FCollisionShape::MakeBox(FVector(ChunkWorldSize * 0.5f - 1.0f));
+	// Middle half of the voxel, a floor or wall has to reach well into a voxel to fill it.
+	const FCollisionShape VoxelShape = FCollisionShape::MakeBox(FVector(VoxelSize * 0.25f));
+
+	const int32 NumChunks = Chunks.Num();
+	const int32 LastChunk = (int32)FMath::Min<int64>((int64)NextBakeChunk + MaxChunks, NumChunks);
+	for (; NextBakeChunk < LastChunk; ++NextBakeChunk)
+	{
+		const int32 cx = NextBakeChunk % ChunkDimensions.X;
+		const int32 cy = (NextBakeChunk / ChunkDimensions.X) % ChunkDimensions.Y;
+		const int32 cz = NextBakeChunk / (ChunkDimensions.X * ChunkDimensions.Y);
+		const FVector ChunkCenter = Origin + (FVector(cx, cy, cz) + 0.5f) * ChunkWorldSize;
+		if (!World->OverlapAnyTestByObjectType(ChunkCenter, FQuat::Identity, ObjectParams, ChunkShape, QueryParams))
+		{
+			continue;
+		}
+
+		// Something is in there, find out which voxels.
+		for (int32 z = cz * ChunkSize; z < FMath::Min((cz + 1) * ChunkSize, Dimensions.Z); ++z)
+		{
+			for (int32 y = cy * ChunkSize; y < FMath::Min((cy + 1) * ChunkSize, Dimensions.Y); ++y)
+			{
+				for (int32 x = cx * ChunkSize; x < FMath::Min((cx + 1) * ChunkSize, Dimensions.X); ++x)
+				{
+					const FVector VoxelCenter = Origin + (FVector(x, y, z) + 0.5f) * VoxelSize;
+					if (World->OverlapAnyTestByObjectType(VoxelCenter, FQuat::Identity, ObjectParams, VoxelShape, QueryParams))
+					{
+						const FIntVector Voxel(x, y, z);
+						Chunks[ChunkIndex(Voxel)] |= VoxelBit(Voxel);
+						++NumOccupied;
+					}
+				}
+			}
+		}
+	}
+
+	bBaked = NextBakeChunk >= NumChunks;
+	return bBaked;
+}
+
+bool FOvermindVoxelGrid::Save(const FString& FileName) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	FVector FileOrigin = Origin;
+	float FileVoxelSize = VoxelSize;
+	FIntVector FileDimensions = Dimensions;
+	int32 FileNumOccupied = NumOccupied;
+	TArray<uint64> FileChunks = Chunks;
+	Writer << FileMagic << FileVersion << FileOrigin << FileVoxelSize << FileDimensions << FileNumOccupied << FileChunks;
+	return FFileHelper::SaveArrayToFile(Bytes, *FileName);
+}
+
+bool FOvermindVoxelGrid::Load(const FString& FileName, const FBox& Bounds, float InVoxelSize)
+{
+	Init(Bounds, InVoxelSize);
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FileName, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 FileMagic = 0;
+	uint16 FileVersion = 0;
+	FVector FileOrigin;
+	float FileVoxelSize = 0.0f;
+	FIntVector FileDimensions;
+	Reader << FileMagic << FileVersion;
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		return false;
+	}
+	Reader << FileOrigin << FileVoxelSize << FileDimensions;
+
+	// Baked for another level layout, bake again.
+	if (!FileOrigin.Equals(Origin, 1.0f) || FileVoxelSize != VoxelSize || FileDimensions != Dimensions)
+	{
+		return false;
+	}
+
+	TArray<uint64> FileChunks;
+	Reader << NumOccupied << FileChunks;
+	if (Reader.IsError() || FileChunks.Num() != Chunks.Num())
+	{
+		NumOccupied = 0;
+		return false;
+	}
+	Chunks = MoveTemp(FileChunks);
+	bBaked = true;
+	return true;
+}
+
+bool FOvermindVoxelGrid::HasLineOfSight(const FVector& Start, const FVector& End) const
+{
+	if (!bBaked)
+	{
+		return true;
+	}
+
+	// Work in voxel units from here on.
+	const FVector From = (Start - Origin) / VoxelSize;
+	const FVector To = (End - Origin) / VoxelSize;
+	const FVector Direction = To - From;
+	const FIntVector StartVoxel(FMath::FloorToInt(From.X), FMath::FloorToInt(From.Y), FMath::FloorToInt(From.Z));
+	const FIntVector EndVoxel(FMath::FloorToInt(To.X), FMath::FloorToInt(To.Y), FMath::FloorToInt(To.Z));
+
+	// Clip the segment to the grid.
+	float TEnter = 0.0f;
+	float TExit = 1.0f;
+	const FVector GridSize(Dimensions);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Abs(Direction[Axis]) < KINDA_SMALL_NUMBER)
+		{
+			if (From[Axis] < 0.0f || From[Axis] >= GridSize[Axis])
+			{
+				return true;
+			}
+			continue;
+		}
+		float T0 = (0.0f - From[Axis]) / Direction[Axis];
+		float T1 = (GridSize[Axis] - From[Axis]) / Direction[Axis];
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+		TEnter = FMath::Max(TEnter, T0);
+		TExit = FMath::Min(TExit, T1);
+	}
+	if (TEnter > TExit)
+	{
+		return true;
+	}
+
+	const FVector Entry = From + Direction * TEnter;
+	FIntVector Voxel(
+		FMath::Clamp(FMath::FloorToInt(Entry.X), 0, Dimensions.X - 1),
+		FMath::Clamp(FMath::FloorToInt(Entry.Y), 0, Dimensions.Y - 1),
+		FMath::Clamp(FMath::FloorToInt(Entry.Z), 0, Dimensions.Z - 1));
+
+	// Amanatides & Woo, step to whichever voxel boundary the segment crosses first.
+	int32 Step[3];
+	float TMax[3];
+	float TDelta[3];
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (Direction[Axis] > 0.0f)
+		{
+			Step[Axis] = 1;
+			TDelta[Axis] = 1.0f / Direction[Axis];
+			TMax[Axis] = (Voxel[Axis] + 1 - From[Axis]) / Direction[Axis];
+		}
+		else if (Direction[Axis] < 0.0f)
+		{
+			Step[Axis] = -1;
+			TDelta[Axis] = -1.0f / Direction[Axis];
+			TMax[Axis] = (Voxel[Axis] - From[Axis]) / Direction[Axis];
+		}
+		else
+		{
+			Step[Axis] = 0;
+			TDelta[Axis] = MAX_flt;
+			TMax[Axis] = MAX_flt;
+		}
+	}
+
+	while (true)
+	{
+		if (Voxel != StartVoxel && Voxel != EndVoxel && IsOccupied(Voxel))
+		{
+			return false;
+		}
+
+		const int32 Axis = TMax[0] < TMax[1] ? (TMax[0] < TMax[2] ? 0 : 2) : (TMax[1] < TMax[2] ? 1 : 2);
+		if (TMax[Axis] > TExit)
+		{
+			return true;
+		}
+		Voxel[Axis] += Step[Axis];
+		if (Voxel[Axis] < 0 || Voxel[Axis] >= Dimensions[Axis])
+		{
+			return true;
+		}
+		TMax[Axis] += TDelta[Axis];
+	}
+}
@@ -0,0 +1,87 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Low resolution occupancy grid of the static level geometry, used to answer line of sight without the physics scene.
+ * Voxels are one bit each, packed 4x4x4 to a chunk so a chunk is a single uint64. Line of sight walks the voxels
+ * the segment goes through (3D DDA) and stops at the first occupied one. Only reads after baking, safe from worker threads.
+ */
+class NIGHTFALL_API FOvermindVoxelGrid
+{
+public:
+	// Voxels per chunk side.
+	static constexpr int32 ChunkSize = 4;
+
+	// Empty the grid and size it to cover Bounds, every voxel starts free.
+	void Init(const FBox& Bounds, float InVoxelSize);
+
+	/**
+	* Mark every voxel whose middle overlaps static geometry, testing a whole chunk first so empty space is cheap.
+	* Only the middle half of a voxel counts, a floor just under a voxel's center does not fill it and block sight along it.
+	* @param	Channel: Object type of the geometry that blocks sight.
+	*/
+	void Bake(UWorld* World, ECollisionChannel Channel = ECC_WorldStatic);
+
+	/**
+	* Same as Bake, a few chunks at a time so it can be spread over frames. Call it until it returns true, after Init.
+	* @param	MaxChunks: Chunks tested by this call, each one is an overlap test plus one per voxel if something is in it.
+	*/
+	bool BakeStep(UWorld* World, int32 MaxChunks, ECollisionChannel Channel = ECC_WorldStatic);
+
+	// Save or load a baked grid, Load fails if the file was baked for other bounds or voxel size.
+	bool Save(const FString& FileName) const;
+	bool Load(const FString& FileName, const FBox& Bounds, float InVoxelSize);
+
+	// True if no occupied voxel is between Start and End. The voxels of Start and End themselves are not checked,
+	// they are often the floor under an actor. Outside the grid nothing is known and sight is not blocked.
+	bool HasLineOfSight(const FVector& Start, const FVector& End) const;
+
+	FORCEINLINE bool IsOccupied(const FIntVector& Voxel) const
+	{
+		return (Chunks[ChunkIndex(Voxel)] & VoxelBit(Voxel)) != 0;
+	}
+
+	FORCEINLINE bool IsValidVoxel(const FIntVector& Voxel) const
+	{
+		return Voxel.X >= 0 && Voxel.Y >= 0 && Voxel.Z >= 0 && Voxel.X < Dimensions.X && Voxel.Y < Dimensions.Y && Voxel.Z < Dimensions.Z;
+	}
+
+	FORCEINLINE bool IsBaked() const
+	{
+		return bBaked;
+	}
+
+	FORCEINLINE int32 GetNumOccupied() const
+	{
+		return NumOccupied;
+	}
+
+private:
+
+	FORCEINLINE int32 ChunkIndex(const FIntVector& Voxel) const
+	{
+		return (Voxel.X / ChunkSize) + (Voxel.Y / ChunkSize) * ChunkDimensions.X + (Voxel.Z / ChunkSize) * ChunkDimensions.X * ChunkDimensions.Y;
+	}
+
+	static FORCEINLINE uint64 VoxelBit(const FIntVector& Voxel)
+	{
+		return 1ull << ((Voxel.X & 3) | ((Voxel.Y & 3) << 2) | ((Voxel.Z & 3) << 4));
+	}
+
+	static constexpr uint32 Magic = 0x584F564F; // "OVOX"
+	// 2: voxels only filled by geometry in their middle.
+	static constexpr uint16 Version = 2;
+
+	FVector Origin = FVector::ZeroVector;
+	float VoxelSize = 100.0f;
+	FIntVector Dimensions = FIntVector::ZeroValue;
+	FIntVector ChunkDimensions = FIntVector::ZeroValue;
+	TArray<uint64> Chunks;
+	int32 NumOccupied = 0;
+	// Next chunk BakeStep tests.
+	int32 NextBakeChunk = 0;
+	bool bBaked = false;
+};
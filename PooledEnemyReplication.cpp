@@ -0,0 +1,116 @@
+// © 2020 GP Games, Double Trouble Games
+
+
+#include "PooledEnemyReplication.h"
+#include "OvermindBase.h"
+
+void FPooledEnemyEntry::PostReplicatedAdd(const FPooledEnemyArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ApplyPooledEnemyState(*this);
+	}
+}
+
+void FPooledEnemyEntry::PostReplicatedChange(const FPooledEnemyArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ApplyPooledEnemyState(*this);
+	}
+}
+
+void FPooledEnemyArray::AddSlot(AEnemyBase* Enemy, int32 Slot, uint8 TypeIndex, bool bActive, const FVector& Location)
+{
+	FPooledEnemyEntry& Entry = Items.AddDefaulted_GetRef();
+	Entry.Enemy = Enemy;
+	Entry.Slot = (uint16)Slot;
+	Entry.TypeIndex = TypeIndex;
+	Entry.bActive = bActive;
+	Entry.Location = Location;
+	MarkItemDirty(Entry);
+}
+
+void FPooledEnemyArray::SetSlotState(int32 Slot, bool bActive, const FVector& Location)
+{
+	if (!Items.IsValidIndex(Slot))
+	{
+		return;
+	}
+
+	FPooledEnemyEntry& Entry = Items[Slot];
+	Entry.bActive = bActive;
+	Entry.Location = Location;
+	MarkItemDirty(Entry);
+}
+
+void FCrowdProxyEntry::PostReplicatedAdd(const FCrowdProxyArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ApplyCrowdProxyState(*this);
+	}
+}
+
+void FCrowdProxyEntry::PostReplicatedChange(const FCrowdProxyArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ApplyCrowdProxyState(*this);
+	}
+}
+
+void FCrowdProxyEntry::PreReplicatedRemove(const FCrowdProxyArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->RemoveCrowdProxy(Id);
+	}
+}
+
+void FCrowdProxyArray::AddProxy(int32 Id, uint8 TypeIndex, const FVector& Location)
+{
+	IdToItem.Add(Id, Items.Num());
+	FCrowdProxyEntry& Entry = Items.AddDefaulted_GetRef();
+	Entry.Id = Id;
+	Entry.TypeIndex = TypeIndex;
+	Entry.Location = Location;
+	MarkItemDirty(Entry);
+}
+
+void FCrowdProxyArray::RemoveProxy(int32 Id)
+{
+	int32 Item;
+	if (!IdToItem.RemoveAndCopyValue(Id, Item))
+	{
+		return;
+	}
+
+	// Last entry takes its place, order means nothing to clients.
+	Items.RemoveAtSwap(Item, 1, false);
+	if (Items.IsValidIndex(Item))
+	{
+		IdToItem[Items[Item].Id] = Item;
+	}
+	MarkArrayDirty();
+}
+
+void FCrowdProxyArray::SetProxyLocation(int32 Id, const FVector& Location)
+{
+	const int32* Item = IdToItem.Find(Id);
+	if (!Item)
+	{
+		return;
+	}
+
+	FCrowdProxyEntry& Entry = Items[*Item];
+	Entry.Location = Location;
+	MarkItemDirty(Entry);
+}
+
+void FCrowdProxyArray::Clear()
+{
+	Items.Reset();
+	IdToItem.Reset();
+	MarkArrayDirty();
+}
@@ -0,0 +1,163 @@
+// © 2020 GP Games, Double Trouble Games
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "PooledEnemyReplication.generated.h"
+
+class AEnemyBase;
+class AOvermindBase;
+struct FPooledEnemyArray;
+struct FCrowdProxyArray;
+
+// Replicated state of one slot of the Overmind's pool, only sent to clients when it changes.
+USTRUCT()
+struct FPooledEnemyEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FPooledEnemyEntry() : Enemy(nullptr), Slot(0), TypeIndex(MAX_uint8), bActive(false), Location(FVector::ZeroVector)
+	{
+
+	}
+
+	UPROPERTY()
+		AEnemyBase* Enemy;
+
+	UPROPERTY()
+		uint16 Slot;
+
+	// Position of the enemy type on the Overmind's SpawnInfo.
+	UPROPERTY()
+		uint8 TypeIndex;
+
+	UPROPERTY()
+		bool bActive;
+
+	// Where the enemy was placed, rounded to whole units.
+	UPROPERTY()
+		FVector_NetQuantize Location;
+
+	// Client side, apply the slot state on the local enemy.
+	void PostReplicatedAdd(const FPooledEnemyArray& InArraySerializer);
+	void PostReplicatedChange(const FPooledEnemyArray& InArraySerializer);
+};
+
+/**
+ * Pool state of an Overmind, replicated with fast array serialization.
+ * Server marks the slots that changed and clients toggle visibility, collision and location of the enemies themselves,
+ * so bandwidth follows the number of spawns and despawns instead of the size of the pool.
+ */
+USTRUCT()
+struct FPooledEnemyArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FPooledEnemyArray() : Owner(nullptr)
+	{
+
+	}
+
+	UPROPERTY()
+		TArray<FPooledEnemyEntry> Items;
+
+	// Overmind this pool belongs to, set on server and clients.
+	AOvermindBase* Owner;
+
+	// Server side, add a slot for a new enemy of the pool.
+	void AddSlot(AEnemyBase* Enemy, int32 Slot, uint8 TypeIndex, bool bActive, const FVector& Location);
+
+	// Server side, change the state of a slot and send it on the next net update.
+	void SetSlotState(int32 Slot, bool bActive, const FVector& Location);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FPooledEnemyEntry, FPooledEnemyArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FPooledEnemyArray> : public TStructOpsTypeTraitsBase2<FPooledEnemyArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+// Replicated state of one crowd proxy.
+USTRUCT()
+struct FCrowdProxyEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FCrowdProxyEntry() : Id(0), TypeIndex(MAX_uint8), Location(FVector::ZeroVector)
+	{
+
+	}
+
+	// Same id as on the server's crowd.
+	UPROPERTY()
+		int32 Id;
+
+	// Position of the enemy type on the Overmind's SpawnInfo.
+	UPROPERTY()
+		uint8 TypeIndex;
+
+	// Where the proxy was on the last correction, rounded to whole units.
+	UPROPERTY()
+		FVector_NetQuantize Location;
+
+	// Client side, add, move or remove the proxy on the local crowd.
+	void PostReplicatedAdd(const FCrowdProxyArray& InArraySerializer);
+	void PostReplicatedChange(const FCrowdProxyArray& InArraySerializer);
+	void PreReplicatedRemove(const FCrowdProxyArray& InArraySerializer);
+};
+
+/**
+ * Crowd proxies of an Overmind, replicated with fast array serialization.
+ * Clients walk their copy of the crowd toward the players like the server does, so locations are only sent
+ * when proxies are added or removed and every CrowdNetUpdateInterval to correct the drift.
+ */
+USTRUCT()
+struct FCrowdProxyArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FCrowdProxyArray() : Owner(nullptr)
+	{
+
+	}
+
+	UPROPERTY()
+		TArray<FCrowdProxyEntry> Items;
+
+	// Overmind this crowd belongs to, set on server and clients.
+	AOvermindBase* Owner;
+
+	// Server side.
+	void AddProxy(int32 Id, uint8 TypeIndex, const FVector& Location);
+	void RemoveProxy(int32 Id);
+	void SetProxyLocation(int32 Id, const FVector& Location);
+	void Clear();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FCrowdProxyEntry, FCrowdProxyArray>(Items, DeltaParms, *this);
+	}
+
+private:
+
+	// Server side, position of each id in Items.
+	TMap<int32, int32> IdToItem;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCrowdProxyArray> : public TStructOpsTypeTraitsBase2<FCrowdProxyArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};